@@ -0,0 +1,639 @@
+/*
+    Консольные замеры горячих путей SimpleEQ против исходных реализаций плагина.
+    Разделы задаются аргументами командной строки, без аргументов выполняются все:
+    - cascade      BiquadCascade против двух MonoChain из juce::dsp::IIR::Filter;
+                   float, double и состояния double при float-входе
+    - oversampling каскад внутри Oversampler при 1x, 2x и 4x
+    - fft          реализации AnalyzerFFT против performFrequencyOnlyForwardTransform, порядки 11-13
+    - decibels     ядро complexToDecibels против модуля, нормировки и Decibels::gainToDecibels
+    - window       кольцо отсчётов против поотсчётной очереди буферов и сдвига monoBuffer
+    - trace        AnalyzerTraceGenerator + AnalyzerTraceLayer против juce::Path и strokePath
+
+    Набор инструкций новых путей выбирается, как и в плагине, переменной SIMPLEEQ_SIMD:
+    запуск с SIMPLEEQ_SIMD=scalar даёт ту же таблицу на скалярных ядрах.
+    Время - лучший из нескольких повторов; замерять сборку Release.
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <limits>
+#include "../../Source/AnalyzerFFT.h"
+#include "../../Source/SimdDispatch.h"
+#include "../../Source/PluginEditor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr float negativeInfinity = -48.f;
+
+    //Результаты складываются сюда, чтобы оптимизатор не выбросил замеряемый код
+    volatile float sink = 0.f;
+
+    /**Время одного вызова body в наносекундах: лучший из numRuns повторов
+    * по callsPerRun вызовов после прогрева
+    **/
+    template<typename Body>
+    double measure(int callsPerRun, Body&& body)
+    {
+        constexpr int numRuns = 7;
+
+        for( int i = 0; i < callsPerRun; ++i )
+            body();
+
+        auto best = std::numeric_limits<double>::max();
+        for( int run = 0; run < numRuns; ++run )
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for( int i = 0; i < callsPerRun; ++i )
+                body();
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, elapsed * 1.0e9 / callsPerRun);
+        }
+
+        return best;
+    }
+
+    void printHeader(const juce::String& title)
+    {
+        std::cout << std::endl << title << std::endl;
+    }
+
+    //Строка таблицы: время и ускорение относительно reference (исходного пути)
+    void printRow(const juce::String& name, double nanoseconds, double reference)
+    {
+        std::cout << "  " << name.paddedRight(' ', 48)
+                  << juce::String(nanoseconds, 1).paddedLeft(' ', 12) << " ns"
+                  << ("x" + juce::String(reference / nanoseconds, 2)).paddedLeft(' ', 9) << std::endl;
+    }
+
+    //Белый шум -12 дБ, у каждого канала свой
+    void fillWithNoise(juce::AudioBuffer<float>& buffer, int seed)
+    {
+        juce::Random random(seed);
+        for( int ch = 0; ch < buffer.getNumChannels(); ++ch )
+        {
+            auto* samples = buffer.getWritePointer(ch);
+            for( int i = 0; i < buffer.getNumSamples(); ++i )
+                samples[i] = 0.25f * (2.f * random.nextFloat() - 1.f);
+        }
+    }
+
+    //==============================================================================
+    //Вся цепь включена: срезы 48 дБ/октаву на 20 Гц и 18 кГц и пик +6 дБ на 1 кГц - 9 секций
+    FilterSnapshot makeFullChainSnapshot(double rate)
+    {
+        FilterSnapshot snapshot;
+        CutSections cut;
+
+        BiquadDesigner::designButterworthHighPass(rate, 20.0, FilterSnapshot::maxCutSections, cut);
+        snapshot.lowCut = cut.sections;
+        snapshot.numLowCutSections = cut.numSections;
+
+        BiquadDesigner::designButterworthLowPass(rate, 18000.0, FilterSnapshot::maxCutSections, cut);
+        snapshot.highCut = cut.sections;
+        snapshot.numHighCutSections = cut.numSections;
+
+        snapshot.peak = BiquadDesigner::designPeak(rate, 1000.0, 1.0, 6.0);
+        snapshot.sampleRate = rate;
+        return snapshot;
+    }
+
+    template<typename SampleType>
+    void prepareCascade(BiquadCascade<SampleType>& cascade, double rate, int blockSize, int numChannels)
+    {
+        cascade.prepare(blockSize, numChannels);
+
+        const auto snapshot = makeFullChainSnapshot(rate);
+        for( int lane = 0; lane < numChannels; ++lane )
+            cascade.applySnapshot(snapshot, lane);
+    }
+
+    template<typename CutChain, typename CoefficientArray>
+    void setCutCoefficients(CutChain& cut, const CoefficientArray& coefficients)
+    {
+        cut.template get<0>().coefficients = coefficients[0];
+        cut.template get<1>().coefficients = coefficients[1];
+        cut.template get<2>().coefficients = coefficients[2];
+        cut.template get<3>().coefficients = coefficients[3];
+    }
+
+    //Исходный путь: MonoChain на канал с коэффициентами из фабрик JUCE, та же цепь из 9 секций
+    template<typename SampleType>
+    void prepareMonoChain(MonoChainT<SampleType>& chain, double rate, int blockSize)
+    {
+        chain.prepare({ rate, static_cast<juce::uint32>(blockSize), 1 });
+
+        using Design = juce::dsp::FilterDesign<SampleType>;
+        setCutCoefficients(chain.template get<ChainPositions::LowCut>(),
+                           Design::designIIRHighpassHighOrderButterworthMethod(SampleType(20), rate, 8));
+        chain.template get<ChainPositions::Peak>().coefficients =
+            juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter(rate, SampleType(1000), SampleType(1),
+                                                                     juce::Decibels::decibelsToGain(SampleType(6)));
+        setCutCoefficients(chain.template get<ChainPositions::HighCut>(),
+                           Design::designIIRLowpassHighOrderButterworthMethod(SampleType(18000), rate, 8));
+    }
+
+    template<typename SampleType>
+    void processMonoChains(std::array<MonoChainT<SampleType>, 2>& chains, juce::AudioBuffer<SampleType>& buffer)
+    {
+        juce::dsp::AudioBlock<SampleType> block(buffer);
+        for( size_t ch = 0; ch < chains.size(); ++ch )
+        {
+            auto channelBlock = block.getSingleChannelBlock(ch);
+            chains[ch].process(juce::dsp::ProcessContextReplacing<SampleType>(channelBlock));
+        }
+    }
+
+    //==============================================================================
+    void benchmarkCascade()
+    {
+        constexpr int blockSize = 512, numChannels = 2, calls = 2000;
+
+        printHeader("cascade: stereo, 9 sections, " + juce::String(blockSize) + "-sample blocks, time per block");
+
+        //Каждый вызов начинает с одного и того же шума: повторная фильтрация не уводит сигнал в денормалы
+        juce::AudioBuffer<float> source(numChannels, blockSize), buffer(numChannels, blockSize);
+        juce::AudioBuffer<double> doubleSource(numChannels, blockSize), doubleBuffer(numChannels, blockSize);
+        fillWithNoise(source, 1);
+        doubleSource.makeCopyOf(source);
+
+        std::array<MonoChainT<float>, 2> chains;
+        std::array<MonoChainT<double>, 2> doubleChains;
+        for( auto& chain : chains )
+            prepareMonoChain(chain, sampleRate, blockSize);
+        for( auto& chain : doubleChains )
+            prepareMonoChain(chain, sampleRate, blockSize);
+
+        BiquadCascade<float> cascade;
+        BiquadCascade<double> doubleCascade;
+        prepareCascade(cascade, sampleRate, blockSize, numChannels);
+        prepareCascade(doubleCascade, sampleRate, blockSize, numChannels);
+
+        const auto reference = measure(calls, [&]
+        {
+            buffer.makeCopyOf(source, true);
+            processMonoChains(chains, buffer);
+            sink = sink + buffer.getSample(0, blockSize - 1);
+        });
+        printRow("MonoChain<float> x2 (original)", reference, reference);
+
+        printRow("MonoChain<double> x2", measure(calls, [&]
+        {
+            doubleBuffer.makeCopyOf(doubleSource, true);
+            processMonoChains(doubleChains, doubleBuffer);
+            sink = sink + float(doubleBuffer.getSample(0, blockSize - 1));
+        }), reference);
+
+        printRow("BiquadCascade<float>", measure(calls, [&]
+        {
+            buffer.makeCopyOf(source, true);
+            cascade.process(buffer.getArrayOfWritePointers(), numChannels, blockSize);
+            sink = sink + buffer.getSample(0, blockSize - 1);
+        }), reference);
+
+        printRow("BiquadCascade<double>", measure(calls, [&]
+        {
+            doubleBuffer.makeCopyOf(doubleSource, true);
+            doubleCascade.process(doubleBuffer.getArrayOfWritePointers(), numChannels, blockSize);
+            sink = sink + float(doubleBuffer.getSample(0, blockSize - 1));
+        }), reference);
+
+        //Как processWithDoubleState: float-блок переводится в double, обрабатывается и возвращается
+        printRow("BiquadCascade<double>, float I/O", measure(calls, [&]
+        {
+            buffer.makeCopyOf(source, true);
+            for( int ch = 0; ch < numChannels; ++ch )
+            {
+                const auto* src = buffer.getReadPointer(ch);
+                auto* work = doubleBuffer.getWritePointer(ch);
+                for( int i = 0; i < blockSize; ++i )
+                    work[i] = static_cast<double>(src[i]);
+            }
+
+            doubleCascade.process(doubleBuffer.getArrayOfWritePointers(), numChannels, blockSize);
+
+            for( int ch = 0; ch < numChannels; ++ch )
+            {
+                const auto* work = doubleBuffer.getReadPointer(ch);
+                auto* dst = buffer.getWritePointer(ch);
+                for( int i = 0; i < blockSize; ++i )
+                    dst[i] = static_cast<float>(work[i]);
+            }
+
+            sink = sink + buffer.getSample(0, blockSize - 1);
+        }), reference);
+    }
+
+    //==============================================================================
+    void benchmarkOversampling()
+    {
+        constexpr int blockSize = 512, numChannels = 2, calls = 500;
+
+        printHeader("oversampling: stereo, 9 sections, " + juce::String(blockSize) + "-sample blocks, time per block");
+
+        juce::AudioBuffer<float> source(numChannels, blockSize), buffer(numChannels, blockSize);
+        fillWithNoise(source, 2);
+
+        double reference = 0.0;
+        for( auto factor : { 1, 2, 4 } )
+        {
+            //Коэффициенты считаются для повышенной частоты, как в снимке с oversamplingFactor
+            Oversampler<float> oversampler;
+            oversampler.prepare(numChannels, blockSize);
+            oversampler.setFactor(factor);
+
+            BiquadCascade<float> cascade;
+            prepareCascade(cascade, sampleRate * factor, blockSize * factor, numChannels);
+
+            const auto nanoseconds = measure(calls, [&]
+            {
+                buffer.makeCopyOf(source, true);
+                oversampler.process(buffer, numChannels, [&cascade](float* const* channels, int n, int numSamples)
+                {
+                    cascade.process(channels, n, numSamples);
+                });
+                sink = sink + buffer.getSample(0, blockSize - 1);
+            });
+
+            if( factor == 1 )
+                reference = nanoseconds;
+
+            printRow(juce::String(factor) + "x (latency " + juce::String(oversampler.getLatencyInSamples()) + " samples)",
+                     nanoseconds, reference);
+        }
+    }
+
+    //==============================================================================
+    void benchmarkFFT()
+    {
+        printHeader("fft: two channels, time per frame");
+
+        for( int order = 11; order <= 13; ++order )
+        {
+            const auto fftSize = 1 << order;
+            const auto calls = (1 << 20) / fftSize;
+
+            juce::AudioBuffer<float> input(2, fftSize);
+            fillWithNoise(input, order);
+            const auto* left = input.getReadPointer(0);
+            const auto* right = input.getReadPointer(1);
+
+            std::cout << " order " << order << " (" << fftSize << ")" << std::endl;
+
+            //Исходный FFTDataGenerator: буфер двойного размера и модули бинов
+            juce::dsp::FFT juceFFT(order);
+            std::vector<float> workspace(static_cast<size_t>(fftSize * 2));
+            const auto reference = measure(calls, [&]
+            {
+                for( const auto* channel : { left, right } )
+                {
+                    std::fill(workspace.begin(), workspace.end(), 0.f);
+                    std::copy(channel, channel + fftSize, workspace.begin());
+                    juceFFT.performFrequencyOnlyForwardTransform(workspace.data());
+                    sink = sink + workspace[1];
+                }
+            });
+            printRow("juce frequency-only x2 (original)", reference, reference);
+
+            std::vector<float> leftOutput(static_cast<size_t>(fftSize)), rightOutput(static_cast<size_t>(fftSize));
+            for( auto backend : { AnalyzerFFT::Backend::Juce, AnalyzerFFT::Backend::Bundled } )
+            {
+                auto fft = AnalyzerFFT::create(order, backend);
+                const auto name = AnalyzerFFT::getBackendName(backend);
+
+                printRow(name + " real x2", measure(calls, [&]
+                {
+                    fft->performRealForward(left, leftOutput.data());
+                    fft->performRealForward(right, rightOutput.data());
+                    sink = sink + leftOutput[2] + rightOutput[2];
+                }), reference);
+
+                printRow(name + " stereo", measure(calls, [&]
+                {
+                    fft->performStereoForward(left, right, leftOutput.data(), rightOutput.data());
+                    sink = sink + leftOutput[2] + rightOutput[2];
+                }), reference);
+            }
+        }
+    }
+
+    //==============================================================================
+    void benchmarkDecibels()
+    {
+        printHeader("decibels: one channel, time per spectrum");
+
+        for( int order = 11; order <= 13; ++order )
+        {
+            const auto fftSize = 1 << order;
+            const auto numBins = fftSize / 2;
+            const auto calls = (1 << 22) / fftSize;
+
+            //Настоящий спектр шума: пары (re, im) бинов 0..N/2 - 1
+            juce::AudioBuffer<float> input(1, fftSize);
+            fillWithNoise(input, order);
+            std::vector<float> spectrum(static_cast<size_t>(fftSize)), decibels(static_cast<size_t>(numBins));
+            AnalyzerFFT::create(order, AnalyzerFFT::Backend::Bundled)->performRealForward(input.getReadPointer(0), spectrum.data());
+
+            std::cout << " order " << order << " (" << numBins << " bins)" << std::endl;
+
+            //Исходный путь: модуль бина (его считал performFrequencyOnlyForwardTransform),
+            //проверка inf/nan с нормировкой и отдельный цикл Decibels::gainToDecibels
+            const auto reference = measure(calls, [&]
+            {
+                for( int i = 0; i < numBins; ++i )
+                {
+                    const auto re = spectrum[2 * i], im = spectrum[2 * i + 1];
+                    decibels[i] = std::sqrt(re * re + im * im);
+                }
+
+                for( int i = 0; i < numBins; ++i )
+                {
+                    auto v = decibels[i];
+                    if( !std::isinf(v) && !std::isnan(v) )
+                        v /= float(numBins);
+                    else
+                        v = 0.f;
+                    decibels[i] = v;
+                }
+
+                for( int i = 0; i < numBins; ++i )
+                    decibels[i] = juce::Decibels::gainToDecibels(decibels[i], negativeInfinity);
+
+                sink = sink + decibels[1];
+            });
+            printRow("sqrt + normalize + gainToDecibels (original)", reference, reference);
+
+            for( const auto* kernels : { &CascadeKernels::getScalarKernels<float>(), &SimdDispatch::getKernels<float>() } )
+            {
+                printRow(juce::String("complexToDecibels ") + kernels->name, measure(calls, [&]
+                {
+                    kernels->complexToDecibels(spectrum.data(), decibels.data(), numBins, 1.f / float(numBins), negativeInfinity);
+                    sink = sink + decibels[1];
+                }), reference);
+            }
+        }
+    }
+
+    //==============================================================================
+    /**Исходный отвод отсчётов анализатора: аудиопоток пишет блок в буфер по одному отсчёту
+    * и кладёт копии буферов в очередь, поток GUI на каждый буфер сдвигает весь monoBuffer
+    **/
+    struct LegacyAnalyzerWindow
+    {
+        void prepare(int blockSize, int fftSize)
+        {
+            bufferToFill.setSize(1, blockSize);
+            incoming.setSize(1, blockSize);
+            audioBufferFifo.prepare(1, blockSize);
+            monoBuffer.setSize(1, fftSize);
+            monoBuffer.clear();
+            fifoIndex = 0;
+        }
+
+        void update(const juce::AudioBuffer<float>& buffer)
+        {
+            const auto* channelPtr = buffer.getReadPointer(0);
+            for( int i = 0; i < buffer.getNumSamples(); ++i )
+            {
+                if( fifoIndex == bufferToFill.getNumSamples() )
+                {
+                    audioBufferFifo.push(bufferToFill);
+                    fifoIndex = 0;
+                }
+
+                bufferToFill.setSample(0, fifoIndex, channelPtr[i]);
+                ++fifoIndex;
+            }
+        }
+
+        //Окно БПФ - весь monoBuffer после сдвигов
+        const float* pull()
+        {
+            while( audioBufferFifo.getNumAvailableForReading() > 0 )
+            {
+                if( audioBufferFifo.pull(incoming) )
+                {
+                    const auto size = incoming.getNumSamples();
+                    juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
+                                                      monoBuffer.getReadPointer(0, size),
+                                                      monoBuffer.getNumSamples() - size);
+                    juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
+                                                      incoming.getReadPointer(0, 0),
+                                                      size);
+                }
+            }
+
+            return monoBuffer.getReadPointer(0);
+        }
+
+        Fifo<juce::AudioBuffer<float>> audioBufferFifo;
+        juce::AudioBuffer<float> bufferToFill, incoming, monoBuffer;
+        int fifoIndex = 0;
+    };
+
+    void benchmarkWindow()
+    {
+        printHeader("window: one channel, audio thread + analyzer per host block, 50% hop, without the FFT");
+
+        for( int order = 11; order <= 13; ++order )
+        {
+            const auto fftSize = 1 << order;
+            std::cout << " order " << order << " (" << fftSize << ")" << std::endl;
+
+            for( auto blockSize : { 32, 128, 512 } )
+            {
+                const auto calls = 20000;
+
+                juce::AudioBuffer<float> block(1, blockSize);
+                fillWithNoise(block, blockSize);
+                std::vector<float> frame(static_cast<size_t>(fftSize));
+
+                LegacyAnalyzerWindow legacy;
+                legacy.prepare(blockSize, fftSize);
+
+                const auto reference = measure(calls, [&]
+                {
+                    legacy.update(block);
+                    sink = sink + legacy.pull()[fftSize - 1];
+                });
+                printRow(juce::String(blockSize) + "-sample blocks, shift (original)", reference, reference);
+
+                //Кольцо разворачивается в кадр, только когда накопился шаг, как в FFTDataGenerator::copyWindow
+                SingleChannelSampleFifo fifo(Channel::Left);
+                fifo.prepare(blockSize);
+                const auto hop = fftSize / 2;
+
+                printRow(juce::String(blockSize) + "-sample blocks, ring", measure(calls, [&]
+                {
+                    fifo.update(block);
+
+                    const auto available = fifo.getNumSamplesAvailable();
+                    if( available >= hop )
+                    {
+                        const auto window = fifo.readWindow(available / hop * hop, fftSize);
+                        juce::FloatVectorOperations::copy(frame.data(), window.data1, window.size1);
+                        juce::FloatVectorOperations::copy(frame.data() + window.size1, window.data2, window.size2);
+                        sink = sink + frame[static_cast<size_t>(fftSize - 1)];
+                    }
+                }), reference);
+            }
+        }
+    }
+
+    //==============================================================================
+    //Исходный AnalyzerPathGenerator::generatePath: вершина на каждый второй бин
+    juce::Path makeLegacyPath(const float* renderData, juce::Rectangle<float> fftBounds, int fftSize, float binWidth)
+    {
+        auto top = fftBounds.getY();
+        auto bottom = fftBounds.getHeight();
+        auto width = fftBounds.getWidth();
+
+        int numBins = (int)fftSize / 2;
+
+        juce::Path p;
+        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+
+        auto map = [bottom, top](float v)
+        {
+            return juce::jmap(v, negativeInfinity, 0.f, float(bottom+10), top);
+        };
+
+        auto y = map(renderData[0]);
+        if( std::isnan(y) || std::isinf(y) )
+            y = bottom;
+
+        p.startNewSubPath(0, y);
+
+        const int pathResolution = 2;
+        for( int binNum = 1; binNum < numBins; binNum += pathResolution )
+        {
+            y = map(renderData[binNum]);
+
+            if( !std::isnan(y) && !std::isinf(y) )
+            {
+                auto binFreq = binNum * binWidth;
+                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
+                int binX = std::floor(normalizedBinX * width);
+                p.lineTo(binX, y);
+            }
+        }
+
+        return p;
+    }
+
+    void benchmarkTrace()
+    {
+        printHeader("trace: two channels, build + render per frame");
+
+        struct Size { int width, height; float scale; };
+
+        for( int order : { 11, 13 } )
+        {
+            const auto fftSize = 1 << order;
+            const auto numBins = fftSize / 2;
+            const auto binWidth = float(sampleRate / double(fftSize));
+
+            //Спектры шума в дБ, как их отдаёт FFTDataGenerator
+            juce::AudioBuffer<float> input(2, fftSize);
+            fillWithNoise(input, order);
+            auto fft = AnalyzerFFT::create(order, AnalyzerFFT::Backend::Bundled);
+            std::array<std::vector<float>, 2> spectra;
+            for( int ch = 0; ch < 2; ++ch )
+            {
+                spectra[ch].resize(static_cast<size_t>(fftSize));
+                fft->performRealForward(input.getReadPointer(ch), spectra[ch].data());
+                SimdDispatch::getKernels<float>().complexToDecibels(spectra[ch].data(), spectra[ch].data(), numBins,
+                                                                    1.f / float(numBins), negativeInfinity);
+            }
+
+            std::cout << " order " << order << " (" << numBins << " bins)" << std::endl;
+
+            //Область анализатора редактора 480x530 и крупное окно на экране HiDPI
+            for( auto size : { Size { 440, 110, 1.f }, Size { 440, 110, 2.f }, Size { 1000, 300, 2.f } } )
+            {
+                const auto calls = 300;
+                const auto label = juce::String(size.width) + "x" + juce::String(size.height) + " @" + juce::String(juce::roundToInt(size.scale)) + "x";
+
+                //Растр всего ResponseCurveComponent: область анализатора отступает от краёв, как в getAnalysisArea
+                const auto analysisArea = juce::Rectangle<int>(20, 16, size.width, size.height);
+                const auto fftBounds = juce::Rectangle<float>(0.f, 0.f, float(size.width), float(size.height));
+                juce::Image component(juce::Image::ARGB, juce::roundToInt((size.width + 40) * size.scale),
+                                      juce::roundToInt((size.height + 22) * size.scale), true, juce::SoftwareImageType());
+
+                //Исходный путь: Path на канал, копия из очереди путей, перенос в область и обводка общим растеризатором
+                const auto reference = measure(calls, [&]
+                {
+                    component.clear(component.getBounds());
+                    juce::Graphics g(component);
+                    g.addTransform(juce::AffineTransform::scale(size.scale));
+
+                    for( int ch = 0; ch < 2; ++ch )
+                    {
+                        const auto generated = makeLegacyPath(spectra[ch].data(), fftBounds, fftSize, binWidth);
+                        auto path = generated;
+                        path.applyTransform(juce::AffineTransform::translation(float(analysisArea.getX()), float(analysisArea.getY())));
+
+                        g.setColour(ch == 0 ? juce::Colour(97u, 18u, 167u) : juce::Colour(215u, 201u, 134u));
+                        g.strokePath(path, juce::PathStrokeType(1.f));
+                    }
+                });
+                printRow(label + ", Path + strokePath (original)", reference, reference);
+
+                //Новый путь: следы по столбцам в растр области и его наложение, как в ResponseCurveComponent::paint
+                std::array<AnalyzerTraceGenerator<AnalyzerTrace>, 2> generators;
+                std::array<AnalyzerTrace, 2> traces;
+                AnalyzerTraceLayer layer;
+                layer.setSize(juce::roundToInt(size.width * size.scale), juce::roundToInt(size.height * size.scale));
+
+                printRow(label + ", AnalyzerTraceLayer", measure(calls, [&]
+                {
+                    for( int ch = 0; ch < 2; ++ch )
+                    {
+                        generators[ch].generateTrace(spectra[ch].data(), fftBounds, size.scale, fftSize, binWidth, negativeInfinity);
+                        generators[ch].getTrace(traces[ch]);
+                    }
+
+                    layer.clear();
+                    layer.draw(traces[0], juce::Colour(97u, 18u, 167u), size.scale);
+                    layer.draw(traces[1], juce::Colour(215u, 201u, 134u), size.scale);
+
+                    component.clear(component.getBounds());
+                    juce::Graphics g(component);
+                    g.addTransform(juce::AffineTransform::scale(size.scale));
+                    g.drawImage(layer.getImage(), analysisArea.toFloat());
+                }), reference);
+            }
+        }
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    juce::StringArray sections;
+    for( int i = 1; i < argc; ++i )
+        sections.add(juce::String(argv[i]).toLowerCase());
+
+    auto shouldRun = [&sections](const char* name) { return sections.isEmpty() || sections.contains(name); };
+
+    std::cout << "SIMD: " << SimdDispatch::getLevelName(SimdDispatch::getActiveLevel())
+              << ", " << juce::SystemStats::getCpuModel() << std::endl;
+
+    if( shouldRun("cascade") )
+        benchmarkCascade();
+    if( shouldRun("oversampling") )
+        benchmarkOversampling();
+    if( shouldRun("fft") )
+        benchmarkFFT();
+    if( shouldRun("decibels") )
+        benchmarkDecibels();
+    if( shouldRun("window") )
+        benchmarkWindow();
+    if( shouldRun("trace") )
+        benchmarkTrace();
+
+    return 0;
+}
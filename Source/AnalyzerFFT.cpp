@@ -0,0 +1,255 @@
+#include "AnalyzerFFT.h"
+#include "SimdDispatch.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /**Вещественное БПФ размера N через комплексное размера N/2:
+    * z[k] = x[2k] + i x[2k+1], Z = БПФ(z), затем
+    * X[k] = E[k] - i W^k O[k], E = (Z[k] + Z*[N/2-k]) / 2, O = (Z[k] - Z*[N/2-k]) / 2, W = e^(-2 pi i / N).
+    * Комплексное БПФ - проходы Стокхэма с прореживанием по времени над раздельными re/im
+    * (CascadeKernels::fftPass, fftPass4), векторные во всех проходах. Для стерео то же комплексное БПФ,
+    * но полного размера N
+    **/
+    class BundledFFT  : public AnalyzerFFT
+    {
+    public:
+        explicit BundledFFT(int order) :
+        AnalyzerFFT(order),
+        kernels(&SimdDispatch::getKernels<float>()),
+        half(size / 2)
+        {
+            //W^k для разделения вещественного спектра
+            twiddleRe.resize(static_cast<size_t>(half));
+            twiddleIm.resize(static_cast<size_t>(half));
+            for( int k = 0; k < half; ++k )
+            {
+                const auto angle = juce::MathConstants<double>::twoPi * k / size;
+                twiddleRe[k] = static_cast<float>(std::cos(angle));
+                twiddleIm[k] = static_cast<float>(-std::sin(angle));
+            }
+
+            realPlan = makePlan(half);
+            stereoPlan = makePlan(size);
+
+            //Четыре массива в одном блоке со сдвигом на разное число строк кэша: при размерах, кратных 4 КБ,
+            //потоки чтения и записи прохода иначе попадают в одни и те же наборы L1 и вытесняют друг друга
+            workspace.resize(static_cast<size_t>(4 * size + 4 * workspacePadding));
+            for( int i = 0; i < 2; ++i )
+            {
+                re[i] = workspace.data() + (2 * i) * (size + workspacePadding) + i * workspacePadding / 2;
+                im[i] = re[i] + size + workspacePadding;
+            }
+        }
+
+        Backend getBackend() const override { return Backend::Bundled; }
+
+        void performRealForward(const float* input, float* output) override
+        {
+            //Вход прочитан целиком до первой записи в output, поэтому они могут совпадать
+            for( int k = 0; k < half; ++k )
+            {
+                re[0][k] = input[2 * k];
+                im[0][k] = input[2 * k + 1];
+            }
+
+            const auto current = performComplex(half);
+
+            const auto* zr = re[current];
+            const auto* zi = im[current];
+            for( int k = 0; k < half; ++k )
+            {
+                const auto mirrored = (half - k) & (half - 1);
+                const auto ar = zr[k], ai = zi[k];
+                const auto br = zr[mirrored], bi = -zi[mirrored];
+
+                const auto evenRe = 0.5f * (ar + br), evenIm = 0.5f * (ai + bi);
+                const auto oddRe = 0.5f * (ar - br), oddIm = 0.5f * (ai - bi);
+
+                //W^k * O, затем умножение на -i: (x + iy) * -i = y - ix
+                const auto wr = twiddleRe[k], wi = twiddleIm[k];
+                const auto rotatedRe = wr * oddRe - wi * oddIm;
+                const auto rotatedIm = wr * oddIm + wi * oddRe;
+
+                output[2 * k] = evenRe + rotatedIm;
+                output[2 * k + 1] = evenIm - rotatedRe;
+            }
+        }
+
+        void performStereoForward(const float* left, const float* right,
+                                  float* leftOutput, float* rightOutput) override
+        {
+            std::copy(left, left + size, re[0]);
+            std::copy(right, right + size, im[0]);
+
+            const auto current = performComplex(size);
+            kernels->separateStereo(re[current], im[current], size, leftOutput, rightOutput);
+        }
+    private:
+        const CascadeKernels::KernelSet<float>* kernels;
+        const int half;
+
+        std::vector<float> twiddleRe, twiddleIm;
+
+        //Проход БПФ: радикс, длина готовых подспектров и начало его поворотных множителей в passRe/passIm
+        struct Pass
+        {
+            bool radix4;
+            int m;
+            size_t twiddleOffset;
+        };
+
+        std::vector<Pass> realPlan, stereoPlan;
+        std::vector<float> passRe, passIm;
+        //Два буфера для чередования проходов
+        static constexpr int workspacePadding = 48;
+        std::vector<float> workspace;
+        float* re[2];
+        float* im[2];
+
+        void addTwiddle(double angle)
+        {
+            passRe.push_back(static_cast<float>(std::cos(angle)));
+            passIm.push_back(static_cast<float>(-std::sin(angle)));
+        }
+
+        /**Пока подспектры короче вектора, проходы радикса 2 (CascadeKernels::fftPass перемежает их выход),
+        * дальше радикс 4 и, при нечётном остатке, последний проход радикса 2
+        **/
+        std::vector<Pass> makePlan(int length)
+        {
+            std::vector<Pass> plan;
+            int m = 1;
+
+            while( m < length )
+            {
+                const auto radix4 = m >= kernels->laneWidth && m * 4 <= length;
+                plan.push_back({ radix4, m, passRe.size() });
+
+                if( radix4 )
+                {
+                    for( int q = 1; q <= 3; ++q )
+                        for( int k = 0; k < m; ++k )
+                            addTwiddle(juce::MathConstants<double>::halfPi * q * k / m);
+                }
+                else
+                {
+                    for( int k = 0; k < juce::jmax(m, CascadeKernels::fftTwiddleMinSize); ++k )
+                        addTwiddle(juce::MathConstants<double>::pi * (k % m) / m);
+                }
+
+                m *= radix4 ? 4 : 2;
+            }
+
+            return plan;
+        }
+
+        //Комплексное БПФ длины length из re[0]/im[0], возвращает индекс буфера с результатом
+        int performComplex(int length)
+        {
+            int current = 0;
+            for( const auto& pass : length == size ? stereoPlan : realPlan )
+            {
+                const auto perform = pass.radix4 ? kernels->fftPass4 : kernels->fftPass;
+                perform(re[current], im[current], re[1 - current], im[1 - current],
+                      passRe.data() + pass.twiddleOffset, passIm.data() + pass.twiddleOffset, length, pass.m);
+                current = 1 - current;
+            }
+
+            return current;
+        }
+    };
+
+    //==============================================================================
+    class JuceFFT  : public AnalyzerFFT
+    {
+    public:
+        explicit JuceFFT(int order) :
+        AnalyzerFFT(order),
+        fft(order),
+        workspace(static_cast<size_t>(size * 2), 0.f),
+        complexInput(static_cast<size_t>(size)),
+        complexOutput(static_cast<size_t>(size))
+        {
+        }
+
+        Backend getBackend() const override { return Backend::Juce; }
+
+        void performRealForward(const float* input, float* output) override
+        {
+            //juce::dsp::FFT требует буфер двойного размера: он остаётся внутри
+            juce::FloatVectorOperations::copy(workspace.data(), input, size);
+            fft.performRealOnlyForwardTransform(workspace.data(), true);
+            juce::FloatVectorOperations::copy(output, workspace.data(), size);
+        }
+
+        void performStereoForward(const float* left, const float* right,
+                                  float* leftOutput, float* rightOutput) override
+        {
+            for( int i = 0; i < size; ++i )
+                complexInput[i] = { left[i], right[i] };
+
+            fft.perform(complexInput.data(), complexOutput.data(), false);
+
+            const auto* z = reinterpret_cast<const float*>(complexOutput.data());
+            separateStereo(z, z + 1, 2, leftOutput, rightOutput);
+        }
+    private:
+        juce::dsp::FFT fft;
+        std::vector<float> workspace;
+        std::vector<juce::dsp::Complex<float>> complexInput, complexOutput;
+    };
+}
+
+//==============================================================================
+void AnalyzerFFT::separateStereo(const float* re, const float* im, int step, float* leftOutput, float* rightOutput) const
+{
+    for( int k = 0; k < size / 2; ++k )
+    {
+        //Z*[N-k]; для k = 0 это сам Z[0]
+        const auto mirrored = ((size - k) & (size - 1)) * step;
+        const auto ar = re[k * step], ai = im[k * step];
+        const auto br = re[mirrored], bi = -im[mirrored];
+
+        //L = (a + b) / 2, R = (a - b) / 2i: (x + iy) / i = y - ix
+        leftOutput[2 * k] = 0.5f * (ar + br);
+        leftOutput[2 * k + 1] = 0.5f * (ai + bi);
+        rightOutput[2 * k] = 0.5f * (ai - bi);
+        rightOutput[2 * k + 1] = -0.5f * (ar - br);
+    }
+}
+
+juce::String AnalyzerFFT::getBackendName(Backend backend)
+{
+    switch( backend )
+    {
+        case Backend::Bundled: return "bundled";
+        case Backend::Juce: return "juce";
+        default: return {};
+    }
+}
+
+std::unique_ptr<AnalyzerFFT> AnalyzerFFT::create(int order, Backend backend)
+{
+    switch( backend )
+    {
+        case Backend::Bundled:
+            return std::make_unique<BundledFFT>(order);
+        case Backend::Juce:
+            return std::make_unique<JuceFFT>(order);
+        default:
+            return nullptr;
+    }
+}
+
+std::unique_ptr<AnalyzerFFT> AnalyzerFFT::create(int order)
+{
+    auto requested = juce::SystemStats::getEnvironmentVariable("SIMPLEEQ_FFT", {}).trim().toLowerCase();
+
+    for( auto backend : { Backend::Bundled, Backend::Juce } )
+        if( requested.isNotEmpty() && getBackendName(backend) == requested )
+            return create(order, backend);
+
+    return create(order, Backend::Bundled);
+}
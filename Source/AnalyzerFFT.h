@@ -0,0 +1,64 @@
+/*
+    БПФ анализатора спектра с заменяемой реализацией.
+    Вход - fftSize вещественных отсчётов, выход - пары (re, im) бинов 0..fftSize/2 - 1
+    в буфере того же размера (бин Найквиста анализатору не нужен), без буфера двойного размера.
+
+    Стерео считается за одно комплексное БПФ: z = L + iR, спектры разделяются по симметрии
+    L[k] = (Z[k] + Z*[N-k]) / 2, R[k] = (Z[k] - Z*[N-k]) / 2i. Из тех же Z можно получить
+    и середину/бока, и корреляцию каналов по полосам.
+
+    Реализации:
+    - Bundled: свой БПФ (комплексный половинного размера + разделение спектров),
+      проходы Стокхэма собраны под набор инструкций процессора (SimdDispatch)
+    - Juce: juce::dsp::FFT, для сравнения (без IPP/Accelerate - медленный запасной движок)
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+
+class AnalyzerFFT
+{
+public:
+    enum class Backend
+    {
+        Bundled,
+        Juce
+    };
+
+    virtual ~AnalyzerFFT() = default;
+
+    /**Реализация по умолчанию - своя.
+    * Переменная окружения SIMPLEEQ_FFT = bundled | juce задаёт её явно (для замеров).
+    * Создавать вне потока анализа: строит план и таблицы
+    **/
+    static std::unique_ptr<AnalyzerFFT> create(int order);
+    //Конкретная реализация
+    static std::unique_ptr<AnalyzerFFT> create(int order, Backend backend);
+
+    static juce::String getBackendName(Backend backend);
+
+    virtual Backend getBackend() const = 0;
+    int getSize() const { return size; }
+
+    /**Прямое БПФ без нормировки, как juce::dsp::FFT::performRealOnlyForwardTransform.
+    * input и output по getSize() элементов, могут совпадать
+    **/
+    virtual void performRealForward(const float* input, float* output) = 0;
+
+    /**Спектры двух каналов за одно комплексное БПФ размера getSize().
+    * Форматы входа и выхода - как у performRealForward, leftOutput может совпадать с left,
+    * rightOutput - с right
+    **/
+    virtual void performStereoForward(const float* left, const float* right,
+                                      float* leftOutput, float* rightOutput) = 0;
+protected:
+    explicit AnalyzerFFT(int order) : size(1 << order) { }
+
+    /**Разделение спектра z = L + iR на спектры каналов, бины 0..size/2 - 1.
+    * Z[k] = (re[k * step], im[k * step]): step = 1 для раздельных re/im, 2 для пар (re, im)
+    **/
+    void separateStereo(const float* re, const float* im, int step, float* leftOutput, float* rightOutput) const;
+
+    const int size;
+};
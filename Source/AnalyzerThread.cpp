@@ -0,0 +1,43 @@
+#include "AnalyzerThread.h"
+
+AnalyzerThread::AnalyzerThread() :
+juce::Thread("SimpleEQ analyzer")
+{
+    startThread();
+}
+
+AnalyzerThread::~AnalyzerThread()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+void AnalyzerThread::addClient(Client* client)
+{
+    const juce::ScopedLock sl(clientLock);
+    clients.addIfNotAlreadyThere(client);
+}
+
+void AnalyzerThread::removeClient(Client* client)
+{
+    const juce::ScopedLock sl(clientLock);
+    clients.removeFirstMatchingValue(client);
+}
+
+void AnalyzerThread::run()
+{
+    while( ! threadShouldExit() )
+    {
+        const auto passStart = juce::Time::getMillisecondCounter();
+
+        {
+            const juce::ScopedLock sl(clientLock);
+            for( auto* client : clients )
+                client->runAnalysis();
+        }
+
+        const auto elapsed = static_cast<int>(juce::Time::getMillisecondCounter() - passStart);
+        wait(juce::jmax(1, passIntervalMs - elapsed));
+    }
+}
@@ -0,0 +1,36 @@
+/*
+    Общий для всех экземпляров плагина фоновый поток анализатора спектра.
+    Берётся через juce::SharedResourcePointer: один поток на процесс хоста,
+    за один проход обслуживает анализаторы всех открытых редакторов.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+class AnalyzerThread  : private juce::Thread
+{
+public:
+    //Клиент (редактор) выполняет свой анализ в потоке анализатора
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual void runAnalysis() = 0;
+    };
+
+    AnalyzerThread();
+    ~AnalyzerThread() override;
+
+    void addClient(Client* client);
+    //Возвращает управление только после завершения текущего прохода по клиентам
+    void removeClient(Client* client);
+private:
+    //Период прохода - примерно кадр экрана при 60 Гц
+    static constexpr int passIntervalMs = 16;
+
+    juce::CriticalSection clientLock;
+    juce::Array<Client*> clients;
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyzerThread)
+};
@@ -0,0 +1,131 @@
+#include "AnalyzerTrace.h"
+
+void AnalyzerTrace::reset(int numColumns)
+{
+    const auto size = static_cast<size_t>(juce::jmax(0, numColumns));
+    top.assign(size, std::numeric_limits<float>::max());
+    bottom.assign(size, std::numeric_limits<float>::lowest());
+}
+
+void AnalyzerTrace::addLine(int column0, float y0, int column1, float y1)
+{
+    jassert(column0 < column1);
+
+    const auto first = juce::jmax(column0 + 1, 0);
+    const auto last = juce::jmin(column1, getNumColumns() - 1);
+    const auto slope = (y1 - y0) / float(column1 - column0);
+
+    for( int k = first; k <= last; ++k )
+    {
+        const auto yStart = y0 + slope * float(k - 1 - column0);
+        include(k, yStart);
+        include(k, yStart + slope);
+    }
+}
+//==============================================================================
+bool AnalyzerTraceLayer::setSize(int width, int height)
+{
+    width = juce::jmax(1, width);
+    height = juce::jmax(1, height);
+
+    if( image.isValid() && image.getWidth() == width && image.getHeight() == height )
+        return false;
+
+    //Программный растр: BitmapData даёт прямой доступ к пикселям без копий на любой платформе
+    image = juce::Image(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+    dirtyTop.assign(static_cast<size_t>(width), height);
+    dirtyBottom.assign(static_cast<size_t>(width), -1);
+    return true;
+}
+
+void AnalyzerTraceLayer::clear()
+{
+    if( ! image.isValid() )
+        return;
+
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::readWrite);
+
+    for( int x = 0; x < image.getWidth(); ++x )
+    {
+        auto& rowTop = dirtyTop[static_cast<size_t>(x)];
+        auto& rowBottom = dirtyBottom[static_cast<size_t>(x)];
+
+        auto* pixel = data.getPixelPointer(x, juce::jmin(rowTop, image.getHeight() - 1));
+        for( int y = rowTop; y <= rowBottom; ++y )
+        {
+            reinterpret_cast<juce::PixelARGB*>(pixel)->setARGB(0, 0, 0, 0);
+            pixel += data.lineStride;
+        }
+
+        rowTop = image.getHeight();
+        rowBottom = -1;
+    }
+}
+
+void AnalyzerTraceLayer::draw(const AnalyzerTrace& trace, juce::Colour colour, float thickness, juce::Colour fillColour)
+{
+    if( ! image.isValid() )
+        return;
+
+    const auto width = juce::jmin(trace.getNumColumns(), image.getWidth());
+    const auto height = image.getHeight();
+    const auto halfThickness = 0.5f * thickness;
+
+    const auto linePixel = colour.getPixelARGB();
+    const auto fillPixel = fillColour.getPixelARGB();
+    const auto hasFill = ! fillColour.isTransparent();
+
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::readWrite);
+
+    for( int x = 0; x < width; ++x )
+    {
+        if( trace.isEmpty(x) )
+            continue;
+
+        const auto spanTop = trace.top[static_cast<size_t>(x)] - halfThickness;
+        const auto spanBottom = trace.bottom[static_cast<size_t>(x)] + halfThickness;
+        //Заливка начинается от нижней точки центра линии
+        const auto fillTop = trace.bottom[static_cast<size_t>(x)];
+
+        const auto firstRow = juce::jmax(0, static_cast<int>(std::floor(spanTop)));
+        const auto lastRow = hasFill ? height - 1
+                                     : juce::jmin(height - 1, static_cast<int>(std::ceil(spanBottom)) - 1);
+
+        if( firstRow > lastRow )
+            continue;
+
+        auto* pixel = data.getPixelPointer(x, firstRow);
+        for( int y = firstRow; y <= lastRow; ++y )
+        {
+            auto& destination = *reinterpret_cast<juce::PixelARGB*>(pixel);
+            const auto rowTop = float(y), rowBottom = float(y + 1);
+
+            if( hasFill )
+            {
+                const auto fillCoverage = juce::jlimit(0.f, 1.f, rowBottom - fillTop);
+                if( fillCoverage > 0.f )
+                {
+                    auto source = fillPixel;
+                    source.multiplyAlpha(fillCoverage);
+                    destination.blend(source);
+                }
+            }
+
+            //Доля строки [y, y + 1), закрытая линией
+            const auto lineCoverage = juce::jmin(spanBottom, rowBottom) - juce::jmax(spanTop, rowTop);
+            if( lineCoverage > 0.f )
+            {
+                auto source = linePixel;
+                source.multiplyAlpha(juce::jmin(1.f, lineCoverage));
+                destination.blend(source);
+            }
+
+            pixel += data.lineStride;
+        }
+
+        auto& rowTop = dirtyTop[static_cast<size_t>(x)];
+        auto& rowBottom = dirtyBottom[static_cast<size_t>(x)];
+        rowTop = juce::jmin(rowTop, firstRow);
+        rowBottom = juce::jmax(rowBottom, lastRow);
+    }
+}
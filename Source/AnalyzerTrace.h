@@ -0,0 +1,61 @@
+/*
+    След анализатора спектра, растеризуемый по столбцам пикселей.
+    В каждом столбце линия спектра - один вертикальный отрезок [top, bottom] (по центру линии),
+    поэтому след строится за один проход по бинам, а рисуется записью отрезков прямо в растр
+    juce::Image: без вершин juce::Path, копий путей и общего растеризатора контуров.
+    Координаты - физические пиксели области анализатора.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+struct AnalyzerTrace
+{
+    //Пустой след из numColumns столбцов; память переиспользуется
+    void reset(int numColumns);
+
+    int getNumColumns() const { return static_cast<int>(top.size()); }
+    bool isEmpty(int column) const { return top[static_cast<size_t>(column)] > bottom[static_cast<size_t>(column)]; }
+
+    //Расширить отрезок столбца до y; столбцы вне следа пропускаются
+    void include(int column, float y)
+    {
+        if( column < 0 || column >= getNumColumns() )
+            return;
+
+        auto& t = top[static_cast<size_t>(column)];
+        auto& b = bottom[static_cast<size_t>(column)];
+        t = juce::jmin(t, y);
+        b = juce::jmax(b, y);
+    }
+
+    /**Прямая от (column0, y0) до (column1, y1), column0 < column1.
+    * Столбец k получает часть прямой над [k - 1, k], сам column0 не затрагивается
+    **/
+    void addLine(int column0, float y0, int column1, float y1);
+
+    std::vector<float> top, bottom;
+};
+
+//Растр следов под область анализатора
+class AnalyzerTraceLayer
+{
+public:
+    //Размер в физических пикселях; true, если растр создан заново (пустым)
+    bool setSize(int width, int height);
+
+    //Стереть нарисованное с прошлой очистки: только затронутые строки каждого столбца
+    void clear();
+
+    /**Наложить след: линия толщиной thickness пикселей цветом colour (края по вертикали
+    * сглаживаются), под ней до низа растра - заливка fillColour, если он не прозрачный
+    **/
+    void draw(const AnalyzerTrace& trace, juce::Colour colour, float thickness, juce::Colour fillColour = {});
+
+    const juce::Image& getImage() const { return image; }
+private:
+    juce::Image image;
+    //Затронутые строки каждого столбца; dirtyTop > dirtyBottom - столбец чист
+    std::vector<int> dirtyTop, dirtyBottom;
+};
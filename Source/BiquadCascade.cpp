@@ -0,0 +1,127 @@
+#include "BiquadCascade.h"
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::prepare(int maximumBlockSize, int numChannels)
+{
+    jassert(numChannels > 0 && numChannels <= maxChannels);
+
+    //Ширина вектора - по числу каналов, а не самая большая из доступных
+    kernels = &SimdDispatch::getKernelsForLanes<SampleType>(numChannels);
+
+    //Каналы раскладываются по дорожкам группами по ширине вектора
+    const auto laneWidth = kernels->laneWidth;
+    preparedChannels = juce::jlimit(1, maxChannels, numChannels);
+    laneStride = (preparedChannels + laneWidth - 1) / laneWidth * laneWidth;
+
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    interleaved.assign(static_cast<size_t>(maxBlockSize * laneStride), SampleType(0));
+
+    for( int stage = 0; stage < NumStages; ++stage )
+    {
+        for( int lane = 0; lane < maxChannels; ++lane )
+            setStage(stage, lane, {});
+
+        setStageActive(stage, false);
+    }
+
+    rebuildActiveStages();
+    reset();
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::reset()
+{
+    for( int stage = 0; stage < NumStages; ++stage )
+    {
+        std::fill(std::begin(sections.s1[stage]), std::end(sections.s1[stage]), SampleType(0));
+        std::fill(std::begin(sections.s2[stage]), std::end(sections.s2[stage]), SampleType(0));
+    }
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::setStage(int stage, int lane, const BiquadCoefficients& c)
+{
+    jassert(juce::isPositiveAndBelow(stage, (int) NumStages));
+    jassert(juce::isPositiveAndBelow(lane, maxChannels));
+
+    sections.b0[stage][lane] = static_cast<SampleType>(c.b0);
+    sections.b1[stage][lane] = static_cast<SampleType>(c.b1);
+    sections.b2[stage][lane] = static_cast<SampleType>(c.b2);
+    sections.a1[stage][lane] = static_cast<SampleType>(c.a1);
+    sections.a2[stage][lane] = static_cast<SampleType>(c.a2);
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::setStageActive(int stage, bool shouldBeActive)
+{
+    if( stageActive[stage] == shouldBeActive )
+        return;
+
+    //Состояние секции, простоявшей выключенной, устарело - начинаем с нуля
+    if( shouldBeActive )
+    {
+        std::fill(std::begin(sections.s1[stage]), std::end(sections.s1[stage]), SampleType(0));
+        std::fill(std::begin(sections.s2[stage]), std::end(sections.s2[stage]), SampleType(0));
+    }
+
+    stageActive[stage] = shouldBeActive;
+    rebuildActiveStages();
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::rebuildActiveStages()
+{
+    numActiveStages = 0;
+    for( int stage = 0; stage < NumStages; ++stage )
+    {
+        if( stageActive[stage] )
+            activeStages[numActiveStages++] = static_cast<unsigned char>(stage);
+    }
+
+    //Все 4 * 2 * 4 комбинаций крутизны срезов и пика сводятся к числу включённых секций 0..9,
+    //так как секции уже упакованы подряд в activeStages
+    kernel = kernels->process[numActiveStages];
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::applySnapshot(const FilterSnapshot& snapshot, int lane)
+{
+    for( int i = 0; i < FilterSnapshot::maxCutSections; ++i )
+    {
+        setStage(LowCutStage + i, lane, snapshot.lowCut[i]);
+        setStageActive(LowCutStage + i, ! snapshot.lowCutBypassed && i < snapshot.numLowCutSections);
+
+        setStage(HighCutStage + i, lane, snapshot.highCut[i]);
+        setStageActive(HighCutStage + i, ! snapshot.highCutBypassed && i < snapshot.numHighCutSections);
+    }
+
+    setStage(PeakStage, lane, snapshot.peak);
+    setStageActive(PeakStage, ! snapshot.peakBypassed);
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples)
+{
+    jassert(numChannels <= preparedChannels);
+    jassert(maxBlockSize > 0);
+
+    if( maxBlockSize == 0 )
+        return;
+
+    numChannels = juce::jmin(numChannels, preparedChannels);
+
+    //Если хост прислал блок больше заявленного, обрабатываем его частями
+    for( int start = 0; start < numSamples; start += maxBlockSize )
+        processChunk(channels, numChannels, start, juce::jmin(maxBlockSize, numSamples - start));
+}
+
+template<typename SampleType>
+void BiquadCascade<SampleType>::processChunk(SampleType* const* channels, int numChannels, int startSample, int numSamples)
+{
+    kernels->interleave(channels, numChannels, startSample, numSamples, interleaved.data(), laneStride);
+    kernel(sections, activeStages.data(), interleaved.data(), numSamples, laneStride);
+    kernels->deinterleave(interleaved.data(), laneStride, channels, numChannels, startSample, numSamples);
+}
+
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
@@ -0,0 +1,76 @@
+/*
+    Каскад биквадратных фильтров, обрабатывающий сразу несколько каналов:
+    каждый канал живёт в своей дорожке вектора, коэффициенты задаются для каждой дорожки отдельно.
+    Ширина вектора и сами ядра выбираются во время выполнения по процессору и числу каналов (SimdDispatch).
+    Тип отсчётов (float/double) задаёт и тип коэффициентов, и тип состояний секций.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "FilterSnapshot.h"
+#include "CascadeKernels.h"
+#include "SimdDispatch.h"
+
+template<typename SampleType>
+class BiquadCascade
+{
+public:
+    //Максимальное количество каналов, обрабатываемых одним проходом
+    static constexpr int maxChannels = CascadeKernels::maxLanes;
+
+    /**Порядок секций совпадает с MonoChain:
+    * - 0..3 срез низких частот
+    * - 4 пиковая частота
+    * - 5..8 срез высоких частот
+    **/
+    enum Stages
+    {
+        LowCutStage = 0,
+        PeakStage = FilterSnapshot::maxCutSections,
+        HighCutStage = PeakStage + 1,
+        NumStages = HighCutStage + FilterSnapshot::maxCutSections
+    };
+
+    //Выбор ядер и выделение буфера перемежённых отсчётов под раскладку, вызывается из prepareToPlay
+    void prepare(int maximumBlockSize, int numChannels);
+    //Сброс состояния всех секций
+    void reset();
+
+    //Коэффициенты секции для одной дорожки (канала)
+    void setStage(int stage, int lane, const BiquadCoefficients& coefficients);
+    //Включение/выключение секции для всех дорожек
+    void setStageActive(int stage, bool shouldBeActive);
+
+    //Применение снимка к дорожке: коэффициенты и включённые секции
+    void applySnapshot(const FilterSnapshot& snapshot, int lane);
+
+    //Количество каналов, под которое подготовлен каскад
+    int getNumChannels() const { return preparedChannels; }
+
+    //Обработка на месте, numChannels <= getNumChannels()
+    void process(SampleType* const* channels, int numChannels, int numSamples);
+private:
+    static_assert(NumStages == CascadeKernels::maxStages, "Kernel tables are sized for the full chain");
+
+    //Коэффициенты и состояния всех секций в одном выровненном по кэш-линии блоке
+    CascadeKernels::SectionData<SampleType> sections;
+
+    //Номера включённых секций в порядке обработки: горячий цикл обходит только их
+    std::array<bool, NumStages> stageActive {};
+    std::array<unsigned char, NumStages> activeStages {};
+    int numActiveStages { 0 };
+
+    //Набор ядер текущего процессора и ядро под текущее количество включённых секций.
+    //Ядро выбирается только при смене конфигурации, а не на каждом блоке
+    const CascadeKernels::KernelSet<SampleType>* kernels { &CascadeKernels::getScalarKernels<SampleType>() };
+    CascadeKernels::ProcessFn<SampleType> kernel { nullptr };
+
+    //Перемежённые отсчёты: на каждый отсчёт laneStride дорожек (каналы, дополненные до ширины вектора)
+    std::vector<SampleType> interleaved;
+    int maxBlockSize { 0 }, preparedChannels { 0 }, laneStride { 0 };
+
+    void rebuildActiveStages();
+    void processChunk(SampleType* const* channels, int numChannels, int startSample, int numSamples);
+};
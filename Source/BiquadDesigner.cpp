@@ -0,0 +1,118 @@
+#include "BiquadDesigner.h"
+#include <cmath>
+
+//Нормировка секции по a0
+static BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2)
+{
+    const auto invA0 = 1.0 / a0;
+
+    BiquadCoefficients c;
+    c.b0 = b0 * invA0;
+    c.b1 = b1 * invA0;
+    c.b2 = b2 * invA0;
+    c.a1 = a1 * invA0;
+    c.a2 = a2 * invA0;
+    return c;
+}
+
+//Добротность k-й секции фильтра Баттерворта чётного порядка 2 * numSections
+static double butterworthQuality(int section, int numSections)
+{
+    const auto order = 2.0 * numSections;
+    return 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+}
+
+BiquadCoefficients BiquadDesigner::designPeak(double sampleRate, double frequency, double quality, double gainInDecibels)
+{
+    const auto A = std::sqrt(std::pow(10.0, gainInDecibels * 0.05));
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    const auto alpha = std::sin(omega) / (quality * 2.0);
+    const auto c2 = -2.0 * std::cos(omega);
+
+    const auto alphaTimesA = alpha * A;
+    const auto alphaOverA = alpha / A;
+
+    return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+                     1.0 + alphaOverA,  c2, 1.0 - alphaOverA);
+}
+
+void BiquadDesigner::designButterworthHighPass(double sampleRate, double frequency, int numSections, CutSections& result)
+{
+    jassert(numSections > 0 && numSections <= FilterSnapshot::maxCutSections);
+
+    const auto n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+
+    result.numSections = numSections;
+    for( int i = 0; i < numSections; ++i )
+    {
+        const auto invQ = 1.0 / butterworthQuality(i, numSections);
+        result.sections[i] = normalise(1.0, -2.0, 1.0,
+                                       1.0 + invQ * n + nSquared,
+                                       2.0 * (nSquared - 1.0),
+                                       1.0 - invQ * n + nSquared);
+    }
+}
+
+void BiquadDesigner::designButterworthLowPass(double sampleRate, double frequency, int numSections, CutSections& result)
+{
+    jassert(numSections > 0 && numSections <= FilterSnapshot::maxCutSections);
+
+    const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+
+    result.numSections = numSections;
+    for( int i = 0; i < numSections; ++i )
+    {
+        const auto invQ = 1.0 / butterworthQuality(i, numSections);
+        result.sections[i] = normalise(1.0, 2.0, 1.0,
+                                       1.0 + invQ * n + nSquared,
+                                       2.0 * (1.0 - nSquared),
+                                       1.0 - invQ * n + nSquared);
+    }
+}
+//==============================================================================
+BiquadDesignCache::Key BiquadDesignCache::makeKey(double sampleRate, float frequency, float quality, float gainInDecibels, int numSections)
+{
+    //Шаг квантования много меньше шага параметров: 0.001 Гц, 0.001 добротности, 0.01 дБ
+    Key key;
+    key.sampleRate = static_cast<juce::int64>(std::llround(sampleRate * 1000.0));
+    key.frequency = static_cast<juce::int64>(std::llround(frequency * 1000.0));
+    key.quality = static_cast<int>(std::lround(quality * 1000.f));
+    key.gain = static_cast<int>(std::lround(gainInDecibels * 100.f));
+    key.numSections = numSections;
+    return key;
+}
+
+const BiquadCoefficients& BiquadDesignCache::getPeak(double sampleRate, float frequency, float quality, float gainInDecibels)
+{
+    auto key = makeKey(sampleRate, frequency, quality, gainInDecibels, 1);
+    if( auto* cached = peakTable.find(key) )
+        return *cached;
+
+    auto& value = peakTable.insert(key);
+    value = BiquadDesigner::designPeak(sampleRate, frequency, quality, gainInDecibels);
+    return value;
+}
+
+const CutSections& BiquadDesignCache::getLowCut(double sampleRate, float frequency, int numSections)
+{
+    auto key = makeKey(sampleRate, frequency, 0.f, 0.f, numSections);
+    if( auto* cached = lowCutTable.find(key) )
+        return *cached;
+
+    auto& value = lowCutTable.insert(key);
+    BiquadDesigner::designButterworthHighPass(sampleRate, frequency, numSections, value);
+    return value;
+}
+
+const CutSections& BiquadDesignCache::getHighCut(double sampleRate, float frequency, int numSections)
+{
+    auto key = makeKey(sampleRate, frequency, 0.f, 0.f, numSections);
+    if( auto* cached = highCutTable.find(key) )
+        return *cached;
+
+    auto& value = highCutTable.insert(key);
+    BiquadDesigner::designButterworthLowPass(sampleRate, frequency, numSections, value);
+    return value;
+}
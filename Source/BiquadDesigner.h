@@ -0,0 +1,90 @@
+/*
+    Аналитический расчёт биквадратных секций эквалайзера без выделения памяти
+    и небольшой кэш уже рассчитанных коэффициентов.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "FilterSnapshot.h"
+
+//Секции фильтра среза Баттерворта: 1..4 биквада для 12/24/36/48 дБ/октаву
+struct CutSections
+{
+    std::array<BiquadCoefficients, FilterSnapshot::maxCutSections> sections;
+    int numSections { 0 };
+};
+
+/**Формулы совпадают с фабриками JUCE (IIR::Coefficients::makePeakFilter,
+* FilterDesign::designIIR...HighOrderButterworthMethod), но считают в double
+* и пишут результат в массивы фиксированного размера.
+**/
+namespace BiquadDesigner
+{
+    BiquadCoefficients designPeak(double sampleRate, double frequency, double quality, double gainInDecibels);
+
+    void designButterworthHighPass(double sampleRate, double frequency, int numSections, CutSections& result);
+    void designButterworthLowPass(double sampleRate, double frequency, int numSections, CutSections& result);
+}
+
+/**Кэш рассчитанных секций. Ключ - квантованные частота, добротность, усиление,
+* количество секций и частота дискретизации. Таблицы маленькие и с фиксированным размером,
+* вытеснение идёт по кругу. Кэш не потокобезопасен: им владеет поток расчёта фильтров.
+**/
+class BiquadDesignCache
+{
+public:
+    const BiquadCoefficients& getPeak(double sampleRate, float frequency, float quality, float gainInDecibels);
+    const CutSections& getLowCut(double sampleRate, float frequency, int numSections);
+    const CutSections& getHighCut(double sampleRate, float frequency, int numSections);
+private:
+    struct Key
+    {
+        juce::int64 sampleRate { 0 }, frequency { 0 };
+        int quality { 0 }, gain { 0 }, numSections { 0 };
+
+        bool operator== (const Key& other) const
+        {
+            return sampleRate == other.sampleRate && frequency == other.frequency
+                && quality == other.quality && gain == other.gain && numSections == other.numSections;
+        }
+    };
+
+    static Key makeKey(double sampleRate, float frequency, float quality, float gainInDecibels, int numSections);
+
+    template<typename ValueType>
+    struct Table
+    {
+        static constexpr int Capacity = 16;
+
+        //Значение по ключу или nullptr
+        const ValueType* find(const Key& key) const
+        {
+            for( int i = 0; i < numUsed; ++i )
+            {
+                if( keys[i] == key )
+                    return &values[i];
+            }
+
+            return nullptr;
+        }
+
+        //Слот под новый ключ
+        ValueType& insert(const Key& key)
+        {
+            auto index = next;
+            next = (next + 1) % Capacity;
+            numUsed = juce::jmax(numUsed, index + 1);
+
+            keys[index] = key;
+            return values[index];
+        }
+    private:
+        std::array<Key, Capacity> keys;
+        std::array<ValueType, Capacity> values;
+        int numUsed { 0 }, next { 0 };
+    };
+
+    Table<BiquadCoefficients> peakTable;
+    Table<CutSections> lowCutTable, highCutTable;
+};
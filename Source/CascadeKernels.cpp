@@ -0,0 +1,350 @@
+/*
+    Наборы ядер, не требующие особых флагов компиляции:
+    скалярный, SSE2 (базовый для x86-64) и NEON (базовый для ARM64).
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "CascadeKernels.h"
+
+#if SIMPLEEQ_X86_KERNELS
+ #include <emmintrin.h>
+#endif
+
+#if SIMPLEEQ_NEON_KERNELS
+ #include <arm_neon.h>
+ #if defined (__aarch64__) || defined (_M_ARM64)
+  #define SIMPLEEQ_NEON_DOUBLE 1
+ #else
+  #define SIMPLEEQ_NEON_DOUBLE 0
+ #endif
+#endif
+
+namespace CascadeKernels
+{
+namespace
+{
+    //Одна дорожка за раз, без явных векторных инструкций
+    template<typename T>
+    struct ScalarVec
+    {
+        using SampleType = T;
+        static constexpr int width = 1;
+        T v;
+
+        static ScalarVec load(const T* p) { return { *p }; }
+        static void store(T* p, ScalarVec x) { *p = x.v; }
+        static ScalarVec expand(T f) { return { f }; }
+        static ScalarVec zeroIfNotFinite(ScalarVec x) { return { (x.v - x.v == T(0)) ? x.v : T(0) }; }
+        static ScalarVec max(ScalarVec a, ScalarVec b) { return { a.v > b.v ? a.v : b.v }; }
+        static ScalarVec loadSquaredMagnitude(const T* p) { return { p[0] * p[0] + p[1] * p[1] }; }
+
+        //Разбор числа IEEE 754 на показатель и мантиссу в [1, 2)
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        static constexpr int mantissaBits = sizeof(T) == 4 ? 23 : 52;
+        static constexpr Bits exponentMask = sizeof(T) == 4 ? 0xFF : 0x7FF;
+        static constexpr int exponentBias = sizeof(T) == 4 ? 127 : 1023;
+
+        static ScalarVec exponent(ScalarVec x)
+        {
+            Bits bits;
+            std::memcpy(&bits, &x.v, sizeof(bits));
+            return { T(int((bits >> mantissaBits) & exponentMask) - exponentBias) };
+        }
+
+        static ScalarVec mantissa(ScalarVec x)
+        {
+            Bits bits;
+            std::memcpy(&bits, &x.v, sizeof(bits));
+            bits = (bits & ((Bits(1) << mantissaBits) - 1)) | (Bits(exponentBias) << mantissaBits);
+
+            T m;
+            std::memcpy(&m, &bits, sizeof(m));
+            return { m };
+        }
+    };
+
+    template<typename T> inline ScalarVec<T> operator+ (ScalarVec<T> a, ScalarVec<T> b) { return { a.v + b.v }; }
+    template<typename T> inline ScalarVec<T> operator- (ScalarVec<T> a, ScalarVec<T> b) { return { a.v - b.v }; }
+    template<typename T> inline ScalarVec<T> operator* (ScalarVec<T> a, ScalarVec<T> b) { return { a.v * b.v }; }
+    template<typename T> inline ScalarVec<T> operator/ (ScalarVec<T> a, ScalarVec<T> b) { return { a.v / b.v }; }
+
+   #if SIMPLEEQ_X86_KERNELS
+    struct Sse2VecF
+    {
+        using SampleType = float;
+        static constexpr int width = 4;
+        __m128 v;
+
+        static Sse2VecF load(const float* p) { return { _mm_loadu_ps(p) }; }
+        static void store(float* p, Sse2VecF x) { _mm_storeu_ps(p, x.v); }
+        static Sse2VecF expand(float f) { return { _mm_set1_ps(f) }; }
+        //x - x равно нулю только для конечных чисел
+        static Sse2VecF zeroIfNotFinite(Sse2VecF x)
+        {
+            return { _mm_and_ps(_mm_cmpeq_ps(_mm_sub_ps(x.v, x.v), _mm_setzero_ps()), x.v) };
+        }
+        static Sse2VecF max(Sse2VecF a, Sse2VecF b) { return { _mm_max_ps(a.v, b.v) }; }
+        //Пары (re, im) разводятся перестановкой, затем re^2 + im^2
+        static Sse2VecF loadSquaredMagnitude(const float* p)
+        {
+            const auto a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4);
+            const auto re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const auto im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            return { _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)) };
+        }
+        //Перемежение a и b кусками по Chunk элементов: low - первая половина результата, high - вторая
+        template<int Chunk>
+        static void zip(Sse2VecF a, Sse2VecF b, Sse2VecF& low, Sse2VecF& high)
+        {
+            if constexpr( Chunk == 1 )
+            {
+                low.v = _mm_unpacklo_ps(a.v, b.v);
+                high.v = _mm_unpackhi_ps(a.v, b.v);
+            }
+            else
+            {
+                low.v = _mm_movelh_ps(a.v, b.v);
+                high.v = _mm_movehl_ps(b.v, a.v);
+            }
+        }
+        //Элементы в обратном порядке
+        static Sse2VecF reverse(Sse2VecF x) { return { _mm_shuffle_ps(x.v, x.v, _MM_SHUFFLE(0, 1, 2, 3)) }; }
+        static Sse2VecF exponent(Sse2VecF x)
+        {
+            const auto e = _mm_and_si128(_mm_srli_epi32(_mm_castps_si128(x.v), 23), _mm_set1_epi32(0xFF));
+            return { _mm_cvtepi32_ps(_mm_sub_epi32(e, _mm_set1_epi32(127))) };
+        }
+        static Sse2VecF mantissa(Sse2VecF x)
+        {
+            const auto bits = _mm_and_si128(_mm_castps_si128(x.v), _mm_set1_epi32(0x007FFFFF));
+            return { _mm_castsi128_ps(_mm_or_si128(bits, _mm_set1_epi32(0x3F800000))) };
+        }
+    };
+
+    inline Sse2VecF operator+ (Sse2VecF a, Sse2VecF b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline Sse2VecF operator- (Sse2VecF a, Sse2VecF b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline Sse2VecF operator* (Sse2VecF a, Sse2VecF b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline Sse2VecF operator/ (Sse2VecF a, Sse2VecF b) { return { _mm_div_ps(a.v, b.v) }; }
+
+    struct Sse2VecD
+    {
+        using SampleType = double;
+        static constexpr int width = 2;
+        __m128d v;
+
+        static Sse2VecD load(const double* p) { return { _mm_loadu_pd(p) }; }
+        static void store(double* p, Sse2VecD x) { _mm_storeu_pd(p, x.v); }
+        static Sse2VecD expand(double f) { return { _mm_set1_pd(f) }; }
+        static Sse2VecD zeroIfNotFinite(Sse2VecD x)
+        {
+            return { _mm_and_pd(_mm_cmpeq_pd(_mm_sub_pd(x.v, x.v), _mm_setzero_pd()), x.v) };
+        }
+        static Sse2VecD max(Sse2VecD a, Sse2VecD b) { return { _mm_max_pd(a.v, b.v) }; }
+        static Sse2VecD loadSquaredMagnitude(const double* p)
+        {
+            const auto a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2);
+            const auto re = _mm_unpacklo_pd(a, b), im = _mm_unpackhi_pd(a, b);
+            return { _mm_add_pd(_mm_mul_pd(re, re), _mm_mul_pd(im, im)) };
+        }
+        template<int Chunk>
+        static void zip(Sse2VecD a, Sse2VecD b, Sse2VecD& low, Sse2VecD& high)
+        {
+            low.v = _mm_unpacklo_pd(a.v, b.v);
+            high.v = _mm_unpackhi_pd(a.v, b.v);
+        }
+        static Sse2VecD reverse(Sse2VecD x) { return { _mm_shuffle_pd(x.v, x.v, 1) }; }
+        //64-битное целое в double без AVX-512: через «магическое» число 2^52
+        static Sse2VecD exponent(Sse2VecD x)
+        {
+            const auto e = _mm_and_si128(_mm_srli_epi64(_mm_castpd_si128(x.v), 52), _mm_set1_epi64x(0x7FF));
+            const auto asDouble = _mm_castsi128_pd(_mm_or_si128(e, _mm_set1_epi64x(0x4330000000000000LL)));
+            return { _mm_sub_pd(asDouble, _mm_set1_pd(4503599627370496.0 + 1023.0)) };
+        }
+        static Sse2VecD mantissa(Sse2VecD x)
+        {
+            const auto bits = _mm_and_si128(_mm_castpd_si128(x.v), _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+            return { _mm_castsi128_pd(_mm_or_si128(bits, _mm_set1_epi64x(0x3FF0000000000000LL))) };
+        }
+    };
+
+    inline Sse2VecD operator+ (Sse2VecD a, Sse2VecD b) { return { _mm_add_pd(a.v, b.v) }; }
+    inline Sse2VecD operator- (Sse2VecD a, Sse2VecD b) { return { _mm_sub_pd(a.v, b.v) }; }
+    inline Sse2VecD operator* (Sse2VecD a, Sse2VecD b) { return { _mm_mul_pd(a.v, b.v) }; }
+    inline Sse2VecD operator/ (Sse2VecD a, Sse2VecD b) { return { _mm_div_pd(a.v, b.v) }; }
+   #endif
+
+   #if SIMPLEEQ_NEON_KERNELS
+    struct NeonVecF
+    {
+        using SampleType = float;
+        static constexpr int width = 4;
+        float32x4_t v;
+
+        static NeonVecF load(const float* p) { return { vld1q_f32(p) }; }
+        static void store(float* p, NeonVecF x) { vst1q_f32(p, x.v); }
+        static NeonVecF expand(float f) { return { vdupq_n_f32(f) }; }
+        static NeonVecF zeroIfNotFinite(NeonVecF x)
+        {
+            auto finite = vceqq_f32(vsubq_f32(x.v, x.v), vdupq_n_f32(0.f));
+            return { vreinterpretq_f32_u32(vandq_u32(finite, vreinterpretq_u32_f32(x.v))) };
+        }
+        static NeonVecF max(NeonVecF a, NeonVecF b) { return { vmaxq_f32(a.v, b.v) }; }
+        //vld2 сам разводит пары (re, im)
+        static NeonVecF loadSquaredMagnitude(const float* p)
+        {
+            const auto pairs = vld2q_f32(p);
+            return { vaddq_f32(vmulq_f32(pairs.val[0], pairs.val[0]), vmulq_f32(pairs.val[1], pairs.val[1])) };
+        }
+        template<int Chunk>
+        static void zip(NeonVecF a, NeonVecF b, NeonVecF& low, NeonVecF& high)
+        {
+            if constexpr( Chunk == 1 )
+            {
+                const auto zipped = vzipq_f32(a.v, b.v);
+                low.v = zipped.val[0];
+                high.v = zipped.val[1];
+            }
+            else
+            {
+                low.v = vcombine_f32(vget_low_f32(a.v), vget_low_f32(b.v));
+                high.v = vcombine_f32(vget_high_f32(a.v), vget_high_f32(b.v));
+            }
+        }
+        static NeonVecF reverse(NeonVecF x)
+        {
+            const auto pairs = vrev64q_f32(x.v);
+            return { vcombine_f32(vget_high_f32(pairs), vget_low_f32(pairs)) };
+        }
+        static NeonVecF exponent(NeonVecF x)
+        {
+            const auto e = vandq_u32(vshrq_n_u32(vreinterpretq_u32_f32(x.v), 23), vdupq_n_u32(0xFF));
+            return { vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(e), vdupq_n_s32(127))) };
+        }
+        static NeonVecF mantissa(NeonVecF x)
+        {
+            const auto bits = vandq_u32(vreinterpretq_u32_f32(x.v), vdupq_n_u32(0x007FFFFF));
+            return { vreinterpretq_f32_u32(vorrq_u32(bits, vdupq_n_u32(0x3F800000))) };
+        }
+    };
+
+    inline NeonVecF operator+ (NeonVecF a, NeonVecF b) { return { vaddq_f32(a.v, b.v) }; }
+    inline NeonVecF operator- (NeonVecF a, NeonVecF b) { return { vsubq_f32(a.v, b.v) }; }
+    inline NeonVecF operator* (NeonVecF a, NeonVecF b) { return { vmulq_f32(a.v, b.v) }; }
+    inline NeonVecF operator/ (NeonVecF a, NeonVecF b)
+    {
+       #if SIMPLEEQ_NEON_DOUBLE
+        return { vdivq_f32(a.v, b.v) };
+       #else
+        //В 32-битном NEON нет деления: оценка обратного и два шага Ньютона
+        auto reciprocal = vrecpeq_f32(b.v);
+        reciprocal = vmulq_f32(vrecpsq_f32(b.v, reciprocal), reciprocal);
+        reciprocal = vmulq_f32(vrecpsq_f32(b.v, reciprocal), reciprocal);
+        return { vmulq_f32(a.v, reciprocal) };
+       #endif
+    }
+
+    #if SIMPLEEQ_NEON_DOUBLE
+    struct NeonVecD
+    {
+        using SampleType = double;
+        static constexpr int width = 2;
+        float64x2_t v;
+
+        static NeonVecD load(const double* p) { return { vld1q_f64(p) }; }
+        static void store(double* p, NeonVecD x) { vst1q_f64(p, x.v); }
+        static NeonVecD expand(double f) { return { vdupq_n_f64(f) }; }
+        static NeonVecD zeroIfNotFinite(NeonVecD x)
+        {
+            auto finite = vceqq_f64(vsubq_f64(x.v, x.v), vdupq_n_f64(0.0));
+            return { vreinterpretq_f64_u64(vandq_u64(finite, vreinterpretq_u64_f64(x.v))) };
+        }
+        static NeonVecD max(NeonVecD a, NeonVecD b) { return { vmaxq_f64(a.v, b.v) }; }
+        static NeonVecD loadSquaredMagnitude(const double* p)
+        {
+            const auto pairs = vld2q_f64(p);
+            return { vaddq_f64(vmulq_f64(pairs.val[0], pairs.val[0]), vmulq_f64(pairs.val[1], pairs.val[1])) };
+        }
+        template<int Chunk>
+        static void zip(NeonVecD a, NeonVecD b, NeonVecD& low, NeonVecD& high)
+        {
+            low.v = vcombine_f64(vget_low_f64(a.v), vget_low_f64(b.v));
+            high.v = vcombine_f64(vget_high_f64(a.v), vget_high_f64(b.v));
+        }
+        static NeonVecD reverse(NeonVecD x) { return { vextq_f64(x.v, x.v, 1) }; }
+        static NeonVecD exponent(NeonVecD x)
+        {
+            const auto e = vandq_u64(vshrq_n_u64(vreinterpretq_u64_f64(x.v), 52), vdupq_n_u64(0x7FF));
+            return { vsubq_f64(vcvtq_f64_u64(e), vdupq_n_f64(1023.0)) };
+        }
+        static NeonVecD mantissa(NeonVecD x)
+        {
+            const auto bits = vandq_u64(vreinterpretq_u64_f64(x.v), vdupq_n_u64(0x000FFFFFFFFFFFFFULL));
+            return { vreinterpretq_f64_u64(vorrq_u64(bits, vdupq_n_u64(0x3FF0000000000000ULL))) };
+        }
+    };
+
+    inline NeonVecD operator+ (NeonVecD a, NeonVecD b) { return { vaddq_f64(a.v, b.v) }; }
+    inline NeonVecD operator- (NeonVecD a, NeonVecD b) { return { vsubq_f64(a.v, b.v) }; }
+    inline NeonVecD operator* (NeonVecD a, NeonVecD b) { return { vmulq_f64(a.v, b.v) }; }
+    inline NeonVecD operator/ (NeonVecD a, NeonVecD b) { return { vdivq_f64(a.v, b.v) }; }
+    #endif
+   #endif
+
+    constexpr auto allCounts = std::make_integer_sequence<int, maxStages + 1>();
+}
+
+template<>
+const KernelSet<float>& getScalarKernels<float>()
+{
+    static constexpr auto kernels = makeKernelSet<ScalarVec<float>>("scalar", allCounts);
+    return kernels;
+}
+
+template<>
+const KernelSet<double>& getScalarKernels<double>()
+{
+    static constexpr auto kernels = makeKernelSet<ScalarVec<double>>("scalar", allCounts);
+    return kernels;
+}
+
+#if SIMPLEEQ_X86_KERNELS
+template<>
+const KernelSet<float>& getSse2Kernels<float>()
+{
+    static constexpr auto kernels = makeKernelSet<Sse2VecF>("sse2", allCounts);
+    return kernels;
+}
+
+template<>
+const KernelSet<double>& getSse2Kernels<double>()
+{
+    static constexpr auto kernels = makeKernelSet<Sse2VecD>("sse2", allCounts);
+    return kernels;
+}
+#endif
+
+#if SIMPLEEQ_NEON_KERNELS
+template<>
+const KernelSet<float>& getNeonKernels<float>()
+{
+    static constexpr auto kernels = makeKernelSet<NeonVecF>("neon", allCounts);
+    return kernels;
+}
+
+template<>
+const KernelSet<double>& getNeonKernels<double>()
+{
+   #if SIMPLEEQ_NEON_DOUBLE
+    static constexpr auto kernels = makeKernelSet<NeonVecD>("neon", allCounts);
+    return kernels;
+   #else
+    //32-битный NEON не умеет double
+    return getScalarKernels<double>();
+   #endif
+}
+#endif
+}
@@ -0,0 +1,531 @@
+/*
+    Ядра обработки каскада биквадов и спектра анализатора, общие для всех наборов инструкций.
+
+    Заголовок намеренно не подключает JUCE: он включается в единицы трансляции,
+    собранные под конкретный набор инструкций (#pragma target). Каждая функция здесь - шаблон
+    от типа вектора V, а типы векторов объявлены в анонимных пространствах имён своих единиц:
+    экземпляры получают внутреннее связывание, и компоновщик не может подставить копию с AVX
+    в код SSE2/скалярного пути. Поэтому и вспомогательные функции, не использующие V,
+    всё равно принимают его параметром шаблона.
+*/
+
+#pragma once
+#include <cmath>
+#include <utility>
+
+namespace CascadeKernels
+{
+    //Максимум секций в каскаде и каналов (дорожек), обрабатываемых одним каскадом
+    constexpr int maxStages = 9;
+    constexpr int maxLanes = 16;
+
+    //Коэффициенты и состояния всех секций: [секция][дорожка], одним выровненным блоком
+    template<typename SampleType>
+    struct alignas(64) SectionData
+    {
+        SampleType b0[maxStages][maxLanes], b1[maxStages][maxLanes], b2[maxStages][maxLanes];
+        SampleType a1[maxStages][maxLanes], a2[maxStages][maxLanes];
+        SampleType s1[maxStages][maxLanes], s2[maxStages][maxLanes];
+    };
+
+    //Обработка перемежённых отсчётов: laneStride дорожек на отсчёт, кратно ширине вектора
+    template<typename SampleType>
+    using ProcessFn = void (*)(SectionData<SampleType>& data, const unsigned char* stages,
+                               SampleType* interleaved, int numSamples, int laneStride);
+    //Перемежение каналов в дорожки и обратно
+    template<typename SampleType>
+    using InterleaveFn = void (*)(const SampleType* const* channels, int numChannels, int startSample,
+                                  int numSamples, SampleType* interleaved, int laneStride);
+    template<typename SampleType>
+    using DeinterleaveFn = void (*)(const SampleType* interleaved, int laneStride, SampleType* const* channels,
+                                    int numChannels, int startSample, int numSamples);
+    /**Спектр в дБ за один проход: 20 * log10(|X| * scale), не ниже negativeInfinity, inf/nan - как ноль.
+    * complexToDecibels читает пары (re, im), powerToDecibels - готовую мощность |X|^2.
+    * Выход может совпадать со входом
+    **/
+    template<typename SampleType>
+    using DecibelsFn = void (*)(const SampleType* input, SampleType* decibels, int numBins,
+                                SampleType scale, SampleType negativeInfinity);
+
+    /**Один проход комплексного БПФ Стокхэма с прореживанием по времени над раздельными re/im:
+    * length - размер БПФ, m - длина уже готовых подспектров.
+    * fftPass (радикс 2): twiddleRe/Im - w^k = e^(-i pi k / m) для k < m, повторённые до fftTwiddleMinSize значений.
+    * fftPass4 (радикс 4, m не меньше ширины вектора): три таблицы по m значений подряд - w^k, w^2k, w^3k,
+    * w = e^(-i pi / 2m)
+    **/
+    template<typename SampleType>
+    using FFTPassFn = void (*)(const SampleType* inRe, const SampleType* inIm, SampleType* outRe, SampleType* outIm,
+                               const SampleType* twiddleRe, const SampleType* twiddleIm,
+                               int length, int m);
+
+    /**Разделение спектра z = L + iR двух вещественных каналов после комплексного БПФ размера size:
+    * re/im - раздельные части Z, на выходе пары (re, im) бинов 0..size/2 - 1 каждого канала
+    **/
+    template<typename SampleType>
+    using SeparateStereoFn = void (*)(const SampleType* re, const SampleType* im, int size,
+                                      SampleType* leftOutput, SampleType* rightOutput);
+
+    //Самый широкий вектор (AVX512, float): таблицам коротких уровней fftPass хватает стольких значений
+    constexpr int fftTwiddleMinSize = 16;
+
+    /**Амплитудная характеристика произведения секций в дБ на сетке частот.
+    * Для секции |H|^2 = (n0 + n1 phi + n2 phi^2) / (d0 + d1 phi + d2 phi^2), phi = sin^2(w/2),
+    * terms - по 6 чисел (n0, n1, n2, d0, d1, d2) на секцию
+    **/
+    template<typename SampleType>
+    using ResponseFn = void (*)(const SampleType* phi, const SampleType* phiSquared, int numPoints,
+                                const SampleType* terms, int numSections,
+                                SampleType* decibels, SampleType negativeInfinity);
+
+    //Набор ядер, собранных под один набор инструкций и один тип отсчётов
+    template<typename SampleType>
+    struct KernelSet
+    {
+        const char* name;
+        int laneWidth;
+        ProcessFn<SampleType> process[maxStages + 1];
+        InterleaveFn<SampleType> interleave;
+        DeinterleaveFn<SampleType> deinterleave;
+        DecibelsFn<SampleType> complexToDecibels;
+        DecibelsFn<SampleType> powerToDecibels;
+        FFTPassFn<SampleType> fftPass;
+        FFTPassFn<SampleType> fftPass4;
+        SeparateStereoFn<SampleType> separateStereo;
+        ResponseFn<SampleType> biquadResponse;
+    };
+
+    //==============================================================================
+    /**Транспонированная прямая форма II, как в juce::dsp::IIR::Filter.
+    * Количество секций известно на этапе компиляции, внутренний цикл разворачивается,
+    * коэффициенты и состояния группы дорожек остаются в регистрах.
+    **/
+    template<typename V, int NumSections>
+    void processSections(SectionData<typename V::SampleType>& data, const unsigned char* stages,
+                         typename V::SampleType* interleaved, int numSamples, int laneStride)
+    {
+        if constexpr( NumSections == 0 )
+        {
+            (void) data; (void) stages; (void) interleaved; (void) numSamples; (void) laneStride;
+        }
+        else
+        {
+            for( int lane = 0; lane < laneStride; lane += V::width )
+            {
+                V b0[NumSections], b1[NumSections], b2[NumSections], a1[NumSections], a2[NumSections];
+                V s1[NumSections], s2[NumSections];
+
+                for( int k = 0; k < NumSections; ++k )
+                {
+                    const auto stage = stages[k];
+                    b0[k] = V::load(data.b0[stage] + lane);
+                    b1[k] = V::load(data.b1[stage] + lane);
+                    b2[k] = V::load(data.b2[stage] + lane);
+                    a1[k] = V::load(data.a1[stage] + lane);
+                    a2[k] = V::load(data.a2[stage] + lane);
+                    s1[k] = V::load(data.s1[stage] + lane);
+                    s2[k] = V::load(data.s2[stage] + lane);
+                }
+
+                auto* samples = interleaved + lane;
+                for( int i = 0; i < numSamples; ++i, samples += laneStride )
+                {
+                    auto x = V::load(samples);
+
+                    for( int k = 0; k < NumSections; ++k )
+                    {
+                        const auto y = b0[k] * x + s1[k];
+
+                        s1[k] = b1[k] * x - a1[k] * y + s2[k];
+                        s2[k] = b2[k] * x - a2[k] * y;
+
+                        x = y;
+                    }
+
+                    V::store(samples, x);
+                }
+
+                for( int k = 0; k < NumSections; ++k )
+                {
+                    V::store(data.s1[stages[k]] + lane, s1[k]);
+                    V::store(data.s2[stages[k]] + lane, s2[k]);
+                }
+            }
+        }
+    }
+
+    template<typename V, typename T = typename V::SampleType>
+    void interleave(const T* const* channels, int numChannels, int startSample,
+                    int numSamples, T* interleaved, int laneStride)
+    {
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            const auto* src = channels[ch] + startSample;
+            auto* dst = interleaved + ch;
+
+            for( int i = 0; i < numSamples; ++i )
+                dst[i * laneStride] = src[i];
+        }
+    }
+
+    template<typename V, typename T = typename V::SampleType>
+    void deinterleave(const T* interleaved, int laneStride, T* const* channels,
+                      int numChannels, int startSample, int numSamples)
+    {
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            const auto* src = interleaved + ch;
+            auto* dst = channels[ch] + startSample;
+
+            for( int i = 0; i < numSamples; ++i )
+                dst[i] = src[i * laneStride];
+        }
+    }
+
+    /**Быстрый log2 без ветвлений: x = m * 2^e, m в [1, 2),
+    * log2(m) = 2 / ln2 * atanh(t), t = (m - 1) / (m + 1) <= 1/3, ряд до t^7.
+    * Погрешность меньше 2e-5 (меньше 1e-4 дБ), без sqrt и log из библиотеки
+    **/
+    template<typename V>
+    V fastLog2(V x)
+    {
+        using T = typename V::SampleType;
+
+        const auto one = V::expand(T(1));
+        const auto m = V::mantissa(x);
+        const auto t = (m - one) / (m + one);
+        const auto t2 = t * t;
+
+        auto series = V::expand(T(1.0 / 7.0)) * t2 + V::expand(T(1.0 / 5.0));
+        series = series * t2 + V::expand(T(1.0 / 3.0));
+        series = series * t2 + one;
+
+        return V::exponent(x) + V::expand(T(2.0 / 0.6931471805599453)) * t * series;
+    }
+
+    //Общая часть: мощность -> дБ с учётом масштаба амплитуды и нижней границы
+    template<typename V>
+    V powerVectorToDecibels(V power, V offset, V floor)
+    {
+        using T = typename V::SampleType;
+
+        //10 * log10(p) = 10 * log10(2) * log2(p); для p = 0 log2 даёт ~-127 и упирается в floor
+        const auto log2ToDecibels = V::expand(T(3.0102999566398120));
+        return V::max(log2ToDecibels * fastLog2(V::zeroIfNotFinite(power)) + offset, floor);
+    }
+
+    //Хвост, не кратный ширине вектора; V - только ради связывания (см. начало файла)
+    template<typename V, typename T = typename V::SampleType>
+    T powerToDecibelsScalar(T power, T offset, T floor)
+    {
+        power = (power - power == T(0)) ? power : T(0);
+        const auto db = T(10) * std::log10(power) + offset;
+        return db > floor ? db : floor;
+    }
+
+    template<typename V, typename T = typename V::SampleType>
+    void complexToDecibels(const T* complexBins, T* decibels, int numBins, T scale, T negativeInfinity)
+    {
+        const auto offset = T(20) * std::log10(scale);
+        const auto offsetVec = V::expand(offset);
+        const auto floor = V::expand(negativeInfinity);
+
+        //Чтение идёт с индекса 2i, запись - с i, поэтому работа на месте безопасна
+        int i = 0;
+        for( ; i + V::width <= numBins; i += V::width )
+            V::store(decibels + i, powerVectorToDecibels(V::loadSquaredMagnitude(complexBins + 2 * i), offsetVec, floor));
+
+        for( ; i < numBins; ++i )
+        {
+            const auto re = complexBins[2 * i], im = complexBins[2 * i + 1];
+            decibels[i] = powerToDecibelsScalar<V>(re * re + im * im, offset, negativeInfinity);
+        }
+    }
+
+    template<typename V, typename T = typename V::SampleType>
+    void powerToDecibels(const T* power, T* decibels, int numBins, T scale, T negativeInfinity)
+    {
+        const auto offset = T(20) * std::log10(scale);
+        const auto offsetVec = V::expand(offset);
+        const auto floor = V::expand(negativeInfinity);
+
+        int i = 0;
+        for( ; i + V::width <= numBins; i += V::width )
+            V::store(decibels + i, powerVectorToDecibels(V::load(power + i), offsetVec, floor));
+
+        for( ; i < numBins; ++i )
+            decibels[i] = powerToDecibelsScalar<V>(power[i], offset, negativeInfinity);
+    }
+
+    //Проход при m меньше ширины вектора: w^k в нём повторяются с периодом m,
+    //а суммы и разности перемежаются на записи кусками по m (V::zip)
+    template<typename V, int Chunk = 1, typename T = typename V::SampleType>
+    void fftPassShort(const T* inRe, const T* inIm, T* outRe, T* outIm,
+                      const T* twiddleRe, const T* twiddleIm, int length, int m)
+    {
+        if constexpr( Chunk < V::width )
+        {
+            if( m != Chunk )
+                return fftPassShort<V, Chunk * 2>(inRe, inIm, outRe, outIm, twiddleRe, twiddleIm, length, m);
+
+            const auto half = length / 2;
+            const auto wr = V::load(twiddleRe), wi = V::load(twiddleIm);
+
+            for( int t = 0; t < half; t += V::width )
+            {
+                const auto ar = V::load(inRe + t), ai = V::load(inIm + t);
+                auto br = V::load(inRe + half + t), bi = V::load(inIm + half + t);
+
+                //Первый проход: w^0 = 1
+                if constexpr( Chunk > 1 )
+                {
+                    const auto rotatedRe = br * wr - bi * wi;
+                    bi = br * wi + bi * wr;
+                    br = rotatedRe;
+                }
+
+                V low, high;
+                V::template zip<Chunk>(ar + br, ar - br, low, high);
+                V::store(outRe + 2 * t, low);
+                V::store(outRe + 2 * t + V::width, high);
+
+                V::template zip<Chunk>(ai + bi, ai - bi, low, high);
+                V::store(outIm + 2 * t, low);
+                V::store(outIm + 2 * t + V::width, high);
+            }
+        }
+        else
+        {
+            (void) inRe; (void) inIm; (void) outRe; (void) outIm;
+            (void) twiddleRe; (void) twiddleIm; (void) length; (void) m;
+        }
+    }
+
+    /**Бабочки прохода: подспектры длины m из x[j m + k] и x[j m + k + length/2] сливаются в
+    * y[2 j m + k] = a + w^k b, y[2 j m + m + k] = a - w^k b. Выход сразу в естественном порядке.
+    * Чтение сплошное при любом m, поэтому вектор идёт вдоль j m + k и в первых проходах
+    **/
+    template<typename V, typename T = typename V::SampleType>
+    void fftPass(const T* inRe, const T* inIm, T* outRe, T* outIm,
+                 const T* twiddleRe, const T* twiddleIm, int length, int m)
+    {
+        const auto half = length / 2;
+
+        if( m >= V::width )
+        {
+            for( int j = 0; j < half; j += m )
+            {
+                const auto in = j, out = 2 * j;
+
+                for( int k = 0; k < m; k += V::width )
+                {
+                    const auto wr = V::load(twiddleRe + k), wi = V::load(twiddleIm + k);
+                    const auto ar = V::load(inRe + in + k), ai = V::load(inIm + in + k);
+                    const auto br = V::load(inRe + in + half + k), bi = V::load(inIm + in + half + k);
+                    const auto cr = br * wr - bi * wi, ci = br * wi + bi * wr;
+
+                    V::store(outRe + out + k, ar + cr);
+                    V::store(outIm + out + k, ai + ci);
+                    V::store(outRe + out + m + k, ar - cr);
+                    V::store(outIm + out + m + k, ai - ci);
+                }
+            }
+        }
+        else if( half >= V::width )
+        {
+            fftPassShort<V>(inRe, inIm, outRe, outIm, twiddleRe, twiddleIm, length, m);
+        }
+        else
+        {
+            //БПФ короче двух векторов
+            for( int t = 0; t < half; ++t )
+            {
+                const auto k = t % m, out = 2 * (t - k);
+                const auto wr = twiddleRe[k], wi = twiddleIm[k];
+                const auto ar = inRe[t], ai = inIm[t];
+                const auto br = inRe[half + t], bi = inIm[half + t];
+                const auto cr = br * wr - bi * wi, ci = br * wi + bi * wr;
+
+                outRe[out + k] = ar + cr;
+                outIm[out + k] = ai + ci;
+                outRe[out + m + k] = ar - cr;
+                outIm[out + m + k] = ai - ci;
+            }
+        }
+    }
+
+    /**Радикс 4: четыре подспектра длины m из x[j m + k + q length/4], q = 0..3, после поворота на w^qk
+    * сливаются 4-точечным ДПФ в y[4 j m + k + r m]. Проходов вдвое меньше, чем у радикса 2,
+    * и вдвое меньше чтений и записей всего буфера, когда он не помещается в L1
+    **/
+    template<typename V, typename T = typename V::SampleType>
+    void fftPass4(const T* inRe, const T* inIm, T* outRe, T* outIm,
+                  const T* twiddleRe, const T* twiddleIm, int length, int m)
+    {
+        const auto quarter = length / 4;
+
+        for( int j = 0; j < quarter; j += m )
+        {
+            const auto* aRe = inRe + j;
+            const auto* aIm = inIm + j;
+            auto* yRe = outRe + 4 * j;
+            auto* yIm = outIm + 4 * j;
+
+            for( int k = 0; k < m; k += V::width )
+            {
+                const auto a0r = V::load(aRe + k), a0i = V::load(aIm + k);
+
+                auto rotate = [&](int q, V& re, V& im)
+                {
+                    const auto xr = V::load(aRe + q * quarter + k), xi = V::load(aIm + q * quarter + k);
+                    const auto wr = V::load(twiddleRe + (q - 1) * m + k), wi = V::load(twiddleIm + (q - 1) * m + k);
+                    re = xr * wr - xi * wi;
+                    im = xr * wi + xi * wr;
+                };
+
+                V a1r, a1i, a2r, a2i, a3r, a3i;
+                rotate(1, a1r, a1i);
+                rotate(2, a2r, a2i);
+                rotate(3, a3r, a3i);
+
+                const auto s02r = a0r + a2r, s02i = a0i + a2i, d02r = a0r - a2r, d02i = a0i - a2i;
+                const auto s13r = a1r + a3r, s13i = a1i + a3i, d13r = a1r - a3r, d13i = a1i - a3i;
+
+                //y1 = d02 - i d13, y3 = d02 + i d13: (x + iy) * -i = y - ix
+                V::store(yRe + k, s02r + s13r);
+                V::store(yIm + k, s02i + s13i);
+                V::store(yRe + m + k, d02r + d13i);
+                V::store(yIm + m + k, d02i - d13r);
+                V::store(yRe + 2 * m + k, s02r - s13r);
+                V::store(yIm + 2 * m + k, s02i - s13i);
+                V::store(yRe + 3 * m + k, d02r - d13i);
+                V::store(yIm + 3 * m + k, d02i + d13r);
+            }
+        }
+    }
+
+    /**L[k] = (Z[k] + Z*[N-k]) / 2, R[k] = (Z[k] - Z*[N-k]) / 2i. Для вектора подряд идущих k
+    * значения Z[N-k] - вектор с конца спектра в обратном порядке (V::reverse),
+    * пары (re, im) на выходе собирает V::zip
+    **/
+    template<typename V, typename T = typename V::SampleType>
+    void separateStereo(const T* re, const T* im, int size, T* leftOutput, T* rightOutput)
+    {
+        const auto half = size / 2;
+
+        auto separateBin = [&](int k)
+        {
+            //Z*[N-k]; для k = 0 это сам Z[0]
+            const auto mirrored = (size - k) & (size - 1);
+            const auto ar = re[k], ai = im[k];
+            const auto br = re[mirrored], bi = -im[mirrored];
+
+            //(x + iy) / i = y - ix
+            leftOutput[2 * k] = T(0.5) * (ar + br);
+            leftOutput[2 * k + 1] = T(0.5) * (ai + bi);
+            rightOutput[2 * k] = T(0.5) * (ai - bi);
+            rightOutput[2 * k + 1] = T(-0.5) * (ar - br);
+        };
+
+        separateBin(0);
+        int k = 1;
+
+        if constexpr( V::width > 1 )
+        {
+            const auto scale = V::expand(T(0.5));
+
+            for( ; k + V::width <= half; k += V::width )
+            {
+                const auto ar = V::load(re + k), ai = V::load(im + k);
+                const auto br = V::reverse(V::load(re + size - k - V::width + 1));
+                const auto bi = V::reverse(V::load(im + size - k - V::width + 1));
+
+                V low, high;
+                V::template zip<1>(scale * (ar + br), scale * (ai - bi), low, high);
+                V::store(leftOutput + 2 * k, low);
+                V::store(leftOutput + 2 * k + V::width, high);
+
+                V::template zip<1>(scale * (ai + bi), scale * (br - ar), low, high);
+                V::store(rightOutput + 2 * k, low);
+                V::store(rightOutput + 2 * k + V::width, high);
+            }
+        }
+
+        for( ; k < half; ++k )
+            separateBin(k);
+    }
+
+    //Числитель и знаменатель перемножаются отдельно, логарифм - один на точку
+    template<typename V, typename T = typename V::SampleType>
+    void biquadResponse(const T* phi, const T* phiSquared, int numPoints, const T* terms, int numSections,
+                        T* decibels, T negativeInfinity)
+    {
+        const auto floor = V::expand(negativeInfinity);
+        const auto log2ToDecibels = V::expand(T(3.0102999566398120));
+
+        int i = 0;
+        for( ; i + V::width <= numPoints; i += V::width )
+        {
+            const auto p1 = V::load(phi + i), p2 = V::load(phiSquared + i);
+            auto numerator = V::expand(T(1)), denominator = V::expand(T(1));
+
+            for( int s = 0; s < numSections; ++s )
+            {
+                const auto* t = terms + 6 * s;
+                numerator = numerator * (V::expand(t[0]) + V::expand(t[1]) * p1 + V::expand(t[2]) * p2);
+                denominator = denominator * (V::expand(t[3]) + V::expand(t[4]) * p1 + V::expand(t[5]) * p2);
+            }
+
+            //Знак у log2 отбрасывается вместе с битом знака: округление около нуля не даёт NaN
+            const auto db = log2ToDecibels * (fastLog2(V::zeroIfNotFinite(numerator)) - fastLog2(V::zeroIfNotFinite(denominator)));
+            V::store(decibels + i, V::max(db, floor));
+        }
+
+        for( ; i < numPoints; ++i )
+        {
+            T numerator = 1, denominator = 1;
+            for( int s = 0; s < numSections; ++s )
+            {
+                const auto* t = terms + 6 * s;
+                numerator *= t[0] + t[1] * phi[i] + t[2] * phiSquared[i];
+                denominator *= t[3] + t[4] * phi[i] + t[5] * phiSquared[i];
+            }
+
+            const auto db = T(10) * std::log10(std::abs(numerator) / denominator);
+            decibels[i] = db > negativeInfinity ? db : negativeInfinity;
+        }
+    }
+
+    //Таблица ядер processSections<V, 0..maxStages>
+    template<typename V, int... Counts>
+    constexpr KernelSet<typename V::SampleType> makeKernelSet(const char* name, std::integer_sequence<int, Counts...>)
+    {
+        return { name, V::width,
+                 { &processSections<V, Counts>... },
+                 &interleave<V>,
+                 &deinterleave<V>,
+                 &complexToDecibels<V>,
+                 &powerToDecibels<V>,
+                 &fftPass<V>,
+                 &fftPass4<V>,
+                 &separateStereo<V>,
+                 &biquadResponse<V> };
+    }
+
+    //==============================================================================
+    //Наборы ядер для float и double. Каждый определён в своей единице трансляции
+    template<typename SampleType> const KernelSet<SampleType>& getScalarKernels();
+   #if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+    #define SIMPLEEQ_X86_KERNELS 1
+    template<typename SampleType> const KernelSet<SampleType>& getSse2Kernels();
+    template<typename SampleType> const KernelSet<SampleType>& getAvx2Kernels();
+    template<typename SampleType> const KernelSet<SampleType>& getAvx512Kernels();
+   #else
+    #define SIMPLEEQ_X86_KERNELS 0
+   #endif
+   #if defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #define SIMPLEEQ_NEON_KERNELS 1
+    template<typename SampleType> const KernelSet<SampleType>& getNeonKernels();
+   #else
+    #define SIMPLEEQ_NEON_KERNELS 0
+   #endif
+}
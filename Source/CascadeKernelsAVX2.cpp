@@ -0,0 +1,172 @@
+/*
+    Набор ядер AVX2. Единица трансляции собирается с целевым набором инструкций
+    только для своих функций, поэтому вызывается лишь после проверки процессора в SimdDispatch.
+*/
+
+#include <cmath>
+#include <utility>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #include <immintrin.h>
+
+ #if defined (__clang__)
+  #pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+ #elif defined (__GNUC__)
+  #pragma GCC push_options
+  #pragma GCC target ("avx2")
+ #endif
+
+#include "CascadeKernels.h"
+
+namespace CascadeKernels
+{
+namespace
+{
+    struct Avx2VecF
+    {
+        using SampleType = float;
+        static constexpr int width = 8;
+        __m256 v;
+
+        static Avx2VecF load(const float* p) { return { _mm256_loadu_ps(p) }; }
+        static void store(float* p, Avx2VecF x) { _mm256_storeu_ps(p, x.v); }
+        static Avx2VecF expand(float f) { return { _mm256_set1_ps(f) }; }
+        static Avx2VecF zeroIfNotFinite(Avx2VecF x)
+        {
+            return { _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(x.v, x.v), _mm256_setzero_ps(), _CMP_EQ_OQ), x.v) };
+        }
+        static Avx2VecF max(Avx2VecF a, Avx2VecF b) { return { _mm256_max_ps(a.v, b.v) }; }
+        //Перестановка внутри 128-битных половин даёт порядок бинов 0 1 4 5 | 2 3 6 7,
+        //его исправляет перестановка 64-битных четвертей
+        static Avx2VecF loadSquaredMagnitude(const float* p)
+        {
+            const auto a = _mm256_loadu_ps(p), b = _mm256_loadu_ps(p + 8);
+            const auto aa = _mm256_mul_ps(a, a), bb = _mm256_mul_ps(b, b);
+            const auto power = _mm256_add_ps(_mm256_shuffle_ps(aa, bb, _MM_SHUFFLE(2, 0, 2, 0)),
+                                             _mm256_shuffle_ps(aa, bb, _MM_SHUFFLE(3, 1, 3, 1)));
+            return { _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(power), _MM_SHUFFLE(3, 1, 2, 0))) };
+        }
+        //Куски до 4 элементов перемежаются внутри 128-битных половин, затем половины собираются по порядку
+        template<int Chunk>
+        static void zip(Avx2VecF a, Avx2VecF b, Avx2VecF& low, Avx2VecF& high)
+        {
+            __m256 first, second;
+
+            if constexpr( Chunk == 1 )
+            {
+                first = _mm256_unpacklo_ps(a.v, b.v);
+                second = _mm256_unpackhi_ps(a.v, b.v);
+            }
+            else if constexpr( Chunk == 2 )
+            {
+                first = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(a.v), _mm256_castps_pd(b.v)));
+                second = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(a.v), _mm256_castps_pd(b.v)));
+            }
+            else
+            {
+                first = a.v;
+                second = b.v;
+            }
+
+            low.v = _mm256_permute2f128_ps(first, second, 0x20);
+            high.v = _mm256_permute2f128_ps(first, second, 0x31);
+        }
+        static Avx2VecF reverse(Avx2VecF x)
+        {
+            return { _mm256_permutevar8x32_ps(x.v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)) };
+        }
+        static Avx2VecF exponent(Avx2VecF x)
+        {
+            const auto e = _mm256_and_si256(_mm256_srli_epi32(_mm256_castps_si256(x.v), 23), _mm256_set1_epi32(0xFF));
+            return { _mm256_cvtepi32_ps(_mm256_sub_epi32(e, _mm256_set1_epi32(127))) };
+        }
+        static Avx2VecF mantissa(Avx2VecF x)
+        {
+            const auto bits = _mm256_and_si256(_mm256_castps_si256(x.v), _mm256_set1_epi32(0x007FFFFF));
+            return { _mm256_castsi256_ps(_mm256_or_si256(bits, _mm256_set1_epi32(0x3F800000))) };
+        }
+    };
+
+    inline Avx2VecF operator+ (Avx2VecF a, Avx2VecF b) { return { _mm256_add_ps(a.v, b.v) }; }
+    inline Avx2VecF operator- (Avx2VecF a, Avx2VecF b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    inline Avx2VecF operator* (Avx2VecF a, Avx2VecF b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    inline Avx2VecF operator/ (Avx2VecF a, Avx2VecF b) { return { _mm256_div_ps(a.v, b.v) }; }
+
+    struct Avx2VecD
+    {
+        using SampleType = double;
+        static constexpr int width = 4;
+        __m256d v;
+
+        static Avx2VecD load(const double* p) { return { _mm256_loadu_pd(p) }; }
+        static void store(double* p, Avx2VecD x) { _mm256_storeu_pd(p, x.v); }
+        static Avx2VecD expand(double f) { return { _mm256_set1_pd(f) }; }
+        static Avx2VecD zeroIfNotFinite(Avx2VecD x)
+        {
+            return { _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(x.v, x.v), _mm256_setzero_pd(), _CMP_EQ_OQ), x.v) };
+        }
+        static Avx2VecD max(Avx2VecD a, Avx2VecD b) { return { _mm256_max_pd(a.v, b.v) }; }
+        static Avx2VecD loadSquaredMagnitude(const double* p)
+        {
+            const auto a = _mm256_loadu_pd(p), b = _mm256_loadu_pd(p + 4);
+            const auto aa = _mm256_mul_pd(a, a), bb = _mm256_mul_pd(b, b);
+            const auto power = _mm256_add_pd(_mm256_unpacklo_pd(aa, bb), _mm256_unpackhi_pd(aa, bb));
+            return { _mm256_permute4x64_pd(power, _MM_SHUFFLE(3, 1, 2, 0)) };
+        }
+        template<int Chunk>
+        static void zip(Avx2VecD a, Avx2VecD b, Avx2VecD& low, Avx2VecD& high)
+        {
+            __m256d first = a.v, second = b.v;
+
+            if constexpr( Chunk == 1 )
+            {
+                first = _mm256_unpacklo_pd(a.v, b.v);
+                second = _mm256_unpackhi_pd(a.v, b.v);
+            }
+
+            low.v = _mm256_permute2f128_pd(first, second, 0x20);
+            high.v = _mm256_permute2f128_pd(first, second, 0x31);
+        }
+        static Avx2VecD reverse(Avx2VecD x) { return { _mm256_permute4x64_pd(x.v, _MM_SHUFFLE(0, 1, 2, 3)) }; }
+        static Avx2VecD exponent(Avx2VecD x)
+        {
+            const auto e = _mm256_and_si256(_mm256_srli_epi64(_mm256_castpd_si256(x.v), 52), _mm256_set1_epi64x(0x7FF));
+            const auto asDouble = _mm256_castsi256_pd(_mm256_or_si256(e, _mm256_set1_epi64x(0x4330000000000000LL)));
+            return { _mm256_sub_pd(asDouble, _mm256_set1_pd(4503599627370496.0 + 1023.0)) };
+        }
+        static Avx2VecD mantissa(Avx2VecD x)
+        {
+            const auto bits = _mm256_and_si256(_mm256_castpd_si256(x.v), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+            return { _mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000LL))) };
+        }
+    };
+
+    inline Avx2VecD operator+ (Avx2VecD a, Avx2VecD b) { return { _mm256_add_pd(a.v, b.v) }; }
+    inline Avx2VecD operator- (Avx2VecD a, Avx2VecD b) { return { _mm256_sub_pd(a.v, b.v) }; }
+    inline Avx2VecD operator* (Avx2VecD a, Avx2VecD b) { return { _mm256_mul_pd(a.v, b.v) }; }
+    inline Avx2VecD operator/ (Avx2VecD a, Avx2VecD b) { return { _mm256_div_pd(a.v, b.v) }; }
+
+    constexpr auto allCounts = std::make_integer_sequence<int, maxStages + 1>();
+}
+
+template<>
+const KernelSet<float>& getAvx2Kernels<float>()
+{
+    static constexpr auto kernels = makeKernelSet<Avx2VecF>("avx2", allCounts);
+    return kernels;
+}
+
+template<>
+const KernelSet<double>& getAvx2Kernels<double>()
+{
+    static constexpr auto kernels = makeKernelSet<Avx2VecD>("avx2", allCounts);
+    return kernels;
+}
+}
+
+ #if defined (__clang__)
+  #pragma clang attribute pop
+ #elif defined (__GNUC__)
+  #pragma GCC pop_options
+ #endif
+#endif
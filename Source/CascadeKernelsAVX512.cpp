@@ -0,0 +1,179 @@
+/*
+    Набор ядер AVX512. Единица трансляции собирается с целевым набором инструкций
+    только для своих функций, поэтому вызывается лишь после проверки процессора в SimdDispatch.
+*/
+
+#include <cmath>
+#include <utility>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ //_mm512_undefined_* в avx512fintrin.h GCC 12 считает неинициализированными (-Wuninitialized)
+ #if defined (__GNUC__) && ! defined (__clang__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wuninitialized"
+  #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+ #endif
+
+ #include <immintrin.h>
+
+ #if defined (__GNUC__) && ! defined (__clang__)
+  #pragma GCC diagnostic pop
+ #endif
+
+ #if defined (__clang__)
+  #pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+ #elif defined (__GNUC__)
+  #pragma GCC push_options
+  #pragma GCC target ("avx512f")
+ #endif
+
+#include "CascadeKernels.h"
+
+namespace CascadeKernels
+{
+namespace
+{
+    /**Индекс permutex2var для перемежения кусками по chunk: элемент i результата берётся из a
+    * или b (width + индекс), начиная с элемента first обоих регистров
+    **/
+    constexpr int zipLane(int i, int chunk, int first, int width)
+    {
+        return (i % (2 * chunk) < chunk ? 0 : width - chunk) + first + i / (2 * chunk) * chunk + i % (2 * chunk);
+    }
+
+    struct Avx512VecF
+    {
+        using SampleType = float;
+        static constexpr int width = 16;
+        __m512 v;
+
+        static Avx512VecF load(const float* p) { return { _mm512_loadu_ps(p) }; }
+        static void store(float* p, Avx512VecF x) { _mm512_storeu_ps(p, x.v); }
+        static Avx512VecF expand(float f) { return { _mm512_set1_ps(f) }; }
+        static Avx512VecF zeroIfNotFinite(Avx512VecF x)
+        {
+            return { _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(_mm512_sub_ps(x.v, x.v), _mm512_setzero_ps(), _CMP_EQ_OQ), x.v) };
+        }
+        static Avx512VecF max(Avx512VecF a, Avx512VecF b) { return { _mm512_max_ps(a.v, b.v) }; }
+        //Чётные (re) и нечётные (im) элементы двух регистров собираются одной перестановкой
+        static Avx512VecF loadSquaredMagnitude(const float* p)
+        {
+            const auto a = _mm512_loadu_ps(p), b = _mm512_loadu_ps(p + 16);
+            const auto aa = _mm512_mul_ps(a, a), bb = _mm512_mul_ps(b, b);
+            const auto even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+            const auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+            return { _mm512_add_ps(_mm512_permutex2var_ps(aa, even, bb), _mm512_permutex2var_ps(aa, odd, bb)) };
+        }
+        template<int Chunk>
+        static void zip(Avx512VecF a, Avx512VecF b, Avx512VecF& low, Avx512VecF& high)
+        {
+            low.v = _mm512_permutex2var_ps(a.v, zipIndex<Chunk, 0>(std::make_integer_sequence<int, width>()), b.v);
+            high.v = _mm512_permutex2var_ps(a.v, zipIndex<Chunk, width / 2>(std::make_integer_sequence<int, width>()), b.v);
+        }
+        template<int Chunk, int First, int... Lanes>
+        static __m512i zipIndex(std::integer_sequence<int, Lanes...>)
+        {
+            alignas(64) static constexpr int index[] = { zipLane(Lanes, Chunk, First, width)... };
+            return _mm512_load_si512(index);
+        }
+        static Avx512VecF reverse(Avx512VecF x)
+        {
+            return { _mm512_permutexvar_ps(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), x.v) };
+        }
+        static Avx512VecF exponent(Avx512VecF x)
+        {
+            const auto e = _mm512_and_si512(_mm512_srli_epi32(_mm512_castps_si512(x.v), 23), _mm512_set1_epi32(0xFF));
+            return { _mm512_cvtepi32_ps(_mm512_sub_epi32(e, _mm512_set1_epi32(127))) };
+        }
+        static Avx512VecF mantissa(Avx512VecF x)
+        {
+            const auto bits = _mm512_and_si512(_mm512_castps_si512(x.v), _mm512_set1_epi32(0x007FFFFF));
+            return { _mm512_castsi512_ps(_mm512_or_si512(bits, _mm512_set1_epi32(0x3F800000))) };
+        }
+    };
+
+    inline Avx512VecF operator+ (Avx512VecF a, Avx512VecF b) { return { _mm512_add_ps(a.v, b.v) }; }
+    inline Avx512VecF operator- (Avx512VecF a, Avx512VecF b) { return { _mm512_sub_ps(a.v, b.v) }; }
+    inline Avx512VecF operator* (Avx512VecF a, Avx512VecF b) { return { _mm512_mul_ps(a.v, b.v) }; }
+    inline Avx512VecF operator/ (Avx512VecF a, Avx512VecF b) { return { _mm512_div_ps(a.v, b.v) }; }
+
+    struct Avx512VecD
+    {
+        using SampleType = double;
+        static constexpr int width = 8;
+        __m512d v;
+
+        static Avx512VecD load(const double* p) { return { _mm512_loadu_pd(p) }; }
+        static void store(double* p, Avx512VecD x) { _mm512_storeu_pd(p, x.v); }
+        static Avx512VecD expand(double f) { return { _mm512_set1_pd(f) }; }
+        static Avx512VecD zeroIfNotFinite(Avx512VecD x)
+        {
+            return { _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(_mm512_sub_pd(x.v, x.v), _mm512_setzero_pd(), _CMP_EQ_OQ), x.v) };
+        }
+        static Avx512VecD max(Avx512VecD a, Avx512VecD b) { return { _mm512_max_pd(a.v, b.v) }; }
+        static Avx512VecD loadSquaredMagnitude(const double* p)
+        {
+            const auto a = _mm512_loadu_pd(p), b = _mm512_loadu_pd(p + 8);
+            const auto aa = _mm512_mul_pd(a, a), bb = _mm512_mul_pd(b, b);
+            const auto even = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+            const auto odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+            return { _mm512_add_pd(_mm512_permutex2var_pd(aa, even, bb), _mm512_permutex2var_pd(aa, odd, bb)) };
+        }
+        template<int Chunk>
+        static void zip(Avx512VecD a, Avx512VecD b, Avx512VecD& low, Avx512VecD& high)
+        {
+            low.v = _mm512_permutex2var_pd(a.v, zipIndex<Chunk, 0>(std::make_integer_sequence<int, width>()), b.v);
+            high.v = _mm512_permutex2var_pd(a.v, zipIndex<Chunk, width / 2>(std::make_integer_sequence<int, width>()), b.v);
+        }
+        template<int Chunk, int First, int... Lanes>
+        static __m512i zipIndex(std::integer_sequence<int, Lanes...>)
+        {
+            alignas(64) static constexpr long long index[] = { zipLane(Lanes, Chunk, First, width)... };
+            return _mm512_load_si512(index);
+        }
+        static Avx512VecD reverse(Avx512VecD x)
+        {
+            return { _mm512_permutexvar_pd(_mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0), x.v) };
+        }
+        static Avx512VecD exponent(Avx512VecD x)
+        {
+            const auto e = _mm512_and_si512(_mm512_srli_epi64(_mm512_castpd_si512(x.v), 52), _mm512_set1_epi64(0x7FF));
+            const auto asDouble = _mm512_castsi512_pd(_mm512_or_si512(e, _mm512_set1_epi64(0x4330000000000000LL)));
+            return { _mm512_sub_pd(asDouble, _mm512_set1_pd(4503599627370496.0 + 1023.0)) };
+        }
+        static Avx512VecD mantissa(Avx512VecD x)
+        {
+            const auto bits = _mm512_and_si512(_mm512_castpd_si512(x.v), _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL));
+            return { _mm512_castsi512_pd(_mm512_or_si512(bits, _mm512_set1_epi64(0x3FF0000000000000LL))) };
+        }
+    };
+
+    inline Avx512VecD operator+ (Avx512VecD a, Avx512VecD b) { return { _mm512_add_pd(a.v, b.v) }; }
+    inline Avx512VecD operator- (Avx512VecD a, Avx512VecD b) { return { _mm512_sub_pd(a.v, b.v) }; }
+    inline Avx512VecD operator* (Avx512VecD a, Avx512VecD b) { return { _mm512_mul_pd(a.v, b.v) }; }
+    inline Avx512VecD operator/ (Avx512VecD a, Avx512VecD b) { return { _mm512_div_pd(a.v, b.v) }; }
+
+    constexpr auto allCounts = std::make_integer_sequence<int, maxStages + 1>();
+}
+
+template<>
+const KernelSet<float>& getAvx512Kernels<float>()
+{
+    static constexpr auto kernels = makeKernelSet<Avx512VecF>("avx512", allCounts);
+    return kernels;
+}
+
+template<>
+const KernelSet<double>& getAvx512Kernels<double>()
+{
+    static constexpr auto kernels = makeKernelSet<Avx512VecD>("avx512", allCounts);
+    return kernels;
+}
+}
+
+ #if defined (__clang__)
+  #pragma clang attribute pop
+ #elif defined (__GNUC__)
+  #pragma GCC pop_options
+ #endif
+#endif
@@ -0,0 +1,94 @@
+#include "FilterDesignWorker.h"
+#include "PluginProcessor.h"
+
+//Параметры, от которых зависит снимок. Анализатор и точность состояний в него не входят:
+//их изменение не должно вызывать пересчёт, а в линейной фазе - перестройку ядра свёртки
+static const char* const designParameterIDs[] =
+{
+    "LowCut Freq", "HighCut Freq",
+    "Peak Freq", "Peak Gain", "Peak Quality",
+    "LowCut Slope", "HighCut Slope",
+    "LowCut Bypassed", "Peak Bypassed", "HighCut Bypassed",
+    "Oversampling", "Phase Mode"
+};
+
+FilterDesignWorker::FilterDesignWorker(juce::AudioProcessorValueTreeState& state,
+                                       FilterSnapshotMailbox& box) :
+juce::Thread("SimpleEQ filter design"),
+apvts(state),
+mailbox(box)
+{
+    for( auto* id : designParameterIDs )
+    {
+        auto* param = apvts.getParameter(id);
+        jassert(param != nullptr);
+        
+        param->addListener(this);
+        designParameters.add(param);
+    }
+}
+
+FilterDesignWorker::~FilterDesignWorker()
+{
+    for( auto* param : designParameters )
+    {
+        param->removeListener(this);
+    }
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+void FilterDesignWorker::prepare(double sampleRate)
+{
+    currentSampleRate.store(sampleRate);
+    updatePending.store(false);
+    designAndPublish();
+
+    startThread();
+}
+
+void FilterDesignWorker::requestUpdate()
+{
+    //Будить поток стоит только при первом запросе: следующие он подберёт тем же проходом
+    if( ! updatePending.exchange(true) )
+        notify();
+}
+
+void FilterDesignWorker::run()
+{
+    while( ! threadShouldExit() )
+    {
+        if( updatePending.exchange(false) )
+            designAndPublish();
+
+        wait(pollIntervalMs);
+    }
+}
+
+void FilterDesignWorker::designAndPublish()
+{
+    //Частота читается под блокировкой: расчёт, начатый до prepare(), закончится раньше,
+    //а следующий уже увидит новую частоту, поэтому снимок старой частоты не опубликуется последним
+    const juce::ScopedLock sl(designLock);
+
+    const auto sampleRate = currentSampleRate.load();
+    if( sampleRate <= 0.0 )
+        return;
+
+    auto& snapshot = mailbox.beginWrite();
+    designFilterSnapshot(getChainSettings(apvts), sampleRate, designCache, snapshot);
+    snapshot.version = nextVersion++;
+
+    if( onSnapshotDesigned != nullptr )
+        onSnapshotDesigned(snapshot);
+
+    mailbox.publish();
+}
+
+void FilterDesignWorker::parameterValueChanged(int, float)
+{
+    //Может прийти из аудиопотока: только флаг, поток заметит его при следующем опросе
+    updatePending.store(true);
+}
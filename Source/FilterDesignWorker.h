@@ -0,0 +1,60 @@
+/*
+    Фоновый поток расчёта коэффициентов фильтров.
+    Пересчитывает снимок только при изменении параметров фильтров и публикует его в FilterSnapshotMailbox.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include "FilterSnapshot.h"
+#include "BiquadDesigner.h"
+
+class FilterDesignWorker  : private juce::Thread,
+                            private juce::AudioProcessorParameter::Listener
+{
+public:
+    FilterDesignWorker(juce::AudioProcessorValueTreeState& apvts,
+                       FilterSnapshotMailbox& mailbox);
+    ~FilterDesignWorker() override;
+
+    //Синхронный расчёт для новой частоты дискретизации и запуск потока
+    void prepare(double sampleRate);
+
+    //Запрос пересчёта с немедленным пробуждением потока (не из аудиопотока)
+    void requestUpdate();
+
+    //Вызывается в потоке расчёта с каждым новым снимком до его публикации.
+    //Назначается до первого prepare
+    std::function<void(const FilterSnapshot&)> onSnapshotDesigned;
+private:
+    juce::AudioProcessorValueTreeState& apvts;
+    FilterSnapshotMailbox& mailbox;
+
+    //Параметры фильтров, передискретизации и режима фазы, на которые подписан поток
+    juce::Array<juce::RangedAudioParameter*> designParameters;
+
+    std::atomic<double> currentSampleRate { 0.0 };
+    std::atomic<bool> updatePending { false };
+
+    /**Период опроса updatePending. Автоматизация приходит в аудиопотоке, поэтому
+    * её изменения только взводят флаг, без notify() (мьютекс WaitableEvent)
+    **/
+    static constexpr int pollIntervalMs = 10;
+
+    juce::uint32 nextVersion { 1 };
+
+    //Кэш секций, используется только под designLock
+    BiquadDesignCache designCache;
+
+    //Защищает писателя почтового ящика: prepare и фоновый поток не должны писать одновременно
+    juce::CriticalSection designLock;
+
+    void run() override;
+    void designAndPublish();
+
+    void parameterValueChanged (int, float) override;
+    void parameterGestureChanged (int, bool) override { }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilterDesignWorker)
+};
@@ -0,0 +1,78 @@
+/*
+    Снимок коэффициентов цепи фильтрации и почтовый ящик для его передачи
+    из потока расчёта фильтров в аудиопоток без блокировок и выделения памяти.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//Коэффициенты одной биквадратной секции (уже нормированы по a0).
+//Хранятся в double: каскад приводит их к своему типу отсчётов сам
+struct BiquadCoefficients
+{
+    double b0 { 1.0 }, b1 { 0.0 }, b2 { 0.0 }, a1 { 0.0 }, a2 { 0.0 };
+};
+
+/**Неизменяемый после публикации снимок всех коэффициентов цепи:
+* - до 4 секций среза низких частот (12/24/36/48 дБ/октаву)
+* - одна секция пиковой частоты
+* - до 4 секций среза высоких частот
+* Коэффициенты рассчитаны для частоты sampleRate * oversamplingFactor.
+**/
+struct FilterSnapshot
+{
+    static constexpr int maxCutSections = 4;
+
+    std::array<BiquadCoefficients, maxCutSections> lowCut, highCut;
+    BiquadCoefficients peak;
+
+    int numLowCutSections { 1 }, numHighCutSections { 1 };
+    bool lowCutBypassed { false }, peakBypassed { false }, highCutBypassed { false };
+
+    double sampleRate { 0.0 };
+    int oversamplingFactor { 1 };
+    //Линейно-фазовый режим: цепь заменяется свёрткой с ядром, построенным по этому снимку
+    bool linearPhase { false };
+    juce::uint32 version { 0 };
+};
+
+/**Почтовый ящик с тройной буферизацией.
+* Писатель (поток расчёта) заполняет свой слот и меняет его местами со средним,
+* читатель (аудиопоток) забирает средний слот одной атомарной операцией обмена.
+* Слоты выделены заранее, так что ни одна из сторон не выделяет память и не ждёт другую.
+**/
+class FilterSnapshotMailbox
+{
+public:
+    //Слот, в который писатель готовит следующий снимок
+    FilterSnapshot& beginWrite() { return slots[writeIndex]; }
+
+    //Публикация подготовленного снимка
+    void publish()
+    {
+        auto previous = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    //Аудиопоток: новый снимок, если он появился с прошлого вызова, иначе nullptr
+    const FilterSnapshot* acquire()
+    {
+        if( (middle.load(std::memory_order_acquire) & freshFlag) == 0 )
+            return nullptr;
+
+        auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return &slots[readIndex];
+    }
+
+    //Аудиопоток: снимок, полученный последним
+    const FilterSnapshot& current() const { return slots[readIndex]; }
+private:
+    static constexpr int freshFlag = 4, indexMask = 3;
+
+    std::array<FilterSnapshot, 3> slots;
+    std::atomic<int> middle { 1 };
+    int writeIndex { 0 }, readIndex { 2 };
+};
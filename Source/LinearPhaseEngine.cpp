@@ -0,0 +1,224 @@
+#include "LinearPhaseEngine.h"
+#include <complex>
+
+//Амплитуда одной секции на нормированной частоте omega
+static double getMagnitude(const BiquadCoefficients& c, double omega)
+{
+    const auto z1 = std::polar(1.0, -omega);
+    const auto z2 = z1 * z1;
+
+    return std::abs(c.b0 + c.b1 * z1 + c.b2 * z2) / std::abs(1.0 + c.a1 * z1 + c.a2 * z2);
+}
+
+//Амплитуда всей цепи с учётом выключенных полос
+static double getMagnitude(const FilterSnapshot& snapshot, double omega)
+{
+    auto magnitude = 1.0;
+
+    if( ! snapshot.lowCutBypassed )
+        for( int i = 0; i < snapshot.numLowCutSections; ++i )
+            magnitude *= getMagnitude(snapshot.lowCut[i], omega);
+
+    if( ! snapshot.peakBypassed )
+        magnitude *= getMagnitude(snapshot.peak, omega);
+
+    if( ! snapshot.highCutBypassed )
+        for( int i = 0; i < snapshot.numHighCutSections; ++i )
+            magnitude *= getMagnitude(snapshot.highCut[i], omega);
+
+    return magnitude;
+}
+
+void LinearPhaseEngine::prepare(double sampleRate, int maximumBlockSize, int numChannels)
+{
+    const juce::ScopedLock sl(designLock);
+
+    currentSampleRate = sampleRate;
+    primedSamples = 0;
+    expectedIRSize.store(0);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    preparedChannels = juce::jlimit(1, maxChannels, numChannels);
+
+    //~170 мс ядра хватает на срез 20 Гц; длина - степень двойки для FFT
+    const auto order = juce::jlimit(10, 15, juce::roundToInt(std::ceil(std::log2(sampleRate * 0.17))));
+    kernelLength = 1 << order;
+
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    fftData.assign(static_cast<size_t>(kernelLength * 2), 0.f);
+
+    //Окно на N + 1 точку: его центр попадает ровно на отсчёт N / 2
+    window.assign(static_cast<size_t>(kernelLength + 1), 0.f);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                             juce::dsp::WindowingFunction<float>::blackman,
+                                                             false);
+
+    conversionBuffer.setSize(preparedChannels, maxBlockSize);
+
+    const auto numPairs = (preparedChannels + 1) / 2;
+    convolutions.clear();
+
+    for( int pair = 0; pair < numPairs; ++pair )
+    {
+        auto convolution = std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::Latency { 0 }, loadQueue);
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = static_cast<juce::uint32>(maxBlockSize);
+        spec.numChannels = static_cast<juce::uint32>(juce::jmin(2, preparedChannels - pair * 2));
+        convolution->prepare(spec);
+
+        convolutions.push_back(std::move(convolution));
+    }
+}
+
+void LinearPhaseEngine::reset()
+{
+    for( auto& convolution : convolutions )
+        convolution->reset();
+
+    primedSamples = 0;
+}
+
+void LinearPhaseEngine::setResponse(const FilterSnapshot& snapshot)
+{
+    const juce::ScopedLock sl(designLock);
+
+    //В минимальной фазе ядро не строится: снимок с переключением на линейную фазу
+    //построит свежее, и isReady дождётся именно его
+    if( fft == nullptr || ! snapshot.linearPhase )
+        return;
+
+    //Коэффициенты рассчитаны на частоте sampleRate * oversamplingFactor:
+    //при передискретизации характеристика у Найквиста не сжата
+    const auto numBins = kernelLength / 2 + 1;
+    const auto omegaScale = juce::MathConstants<double>::twoPi / kernelLength / snapshot.oversamplingFactor;
+
+    //Нулевая фаза: только действительная часть
+    std::fill(fftData.begin(), fftData.end(), 0.f);
+    for( int bin = 0; bin < numBins; ++bin )
+        fftData[static_cast<size_t>(bin * 2)] = static_cast<float>(getMagnitude(snapshot, bin * omegaScale));
+
+    fft->performRealOnlyInverseTransform(fftData.data());
+
+    //Сдвиг на половину длины делает ядро причинным и симметричным, окно убирает обрезку
+    const auto irSize = kernelLength + static_cast<int>(++generation % numGenerationTags);
+    juce::AudioBuffer<float> kernel(1, irSize);
+    kernel.clear();
+    auto* kernelData = kernel.getWritePointer(0);
+    const auto half = kernelLength / 2;
+
+    for( int i = 0; i < kernelLength; ++i )
+        kernelData[i] = fftData[static_cast<size_t>((i + half) % kernelLength)] * window[static_cast<size_t>(i)];
+
+    //До загрузки: свёртки с прежним ядром уже не считаются готовыми
+    expectedIRSize.store(irSize);
+
+    //Моно ядро применяется к обоим каналам пары
+    for( auto& convolution : convolutions )
+    {
+        juce::AudioBuffer<float> copy(kernel);
+        convolution->loadImpulseResponse(std::move(copy),
+                                         currentSampleRate,
+                                         juce::dsp::Convolution::Stereo::no,
+                                         juce::dsp::Convolution::Trim::no,
+                                         juce::dsp::Convolution::Normalise::no);
+    }
+}
+
+void LinearPhaseEngine::process(float* const* channels, int numChannels, int numSamples)
+{
+    numChannels = juce::jmin(numChannels, preparedChannels);
+
+    for( int start = 0; start < numSamples; start += maxBlockSize )
+    {
+        float* chunk[maxChannels];
+        for( int ch = 0; ch < numChannels; ++ch )
+            chunk[ch] = channels[ch] + start;
+
+        processChunk(chunk, numChannels, juce::jmin(maxBlockSize, numSamples - start));
+    }
+}
+
+void LinearPhaseEngine::process(double* const* channels, int numChannels, int numSamples)
+{
+    numChannels = juce::jmin(numChannels, preparedChannels);
+    auto* const* work = conversionBuffer.getArrayOfWritePointers();
+
+    for( int start = 0; start < numSamples; start += maxBlockSize )
+    {
+        const auto chunk = juce::jmin(maxBlockSize, numSamples - start);
+
+        for( int ch = 0; ch < numChannels; ++ch )
+            for( int i = 0; i < chunk; ++i )
+                work[ch][i] = static_cast<float>(channels[ch][start + i]);
+
+        processChunk(work, numChannels, chunk);
+
+        for( int ch = 0; ch < numChannels; ++ch )
+            for( int i = 0; i < chunk; ++i )
+                channels[ch][start + i] = static_cast<double>(work[ch][i]);
+    }
+}
+
+template<typename SampleType>
+void LinearPhaseEngine::primeFrom(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    numChannels = juce::jmin(numChannels, preparedChannels);
+    auto* const* work = conversionBuffer.getArrayOfWritePointers();
+
+    for( int start = 0; start < numSamples; start += maxBlockSize )
+    {
+        const auto chunk = juce::jmin(maxBlockSize, numSamples - start);
+
+        for( int ch = 0; ch < numChannels; ++ch )
+            for( int i = 0; i < chunk; ++i )
+                work[ch][i] = static_cast<float>(channels[ch][start + i]);
+
+        processChunk(work, numChannels, chunk);
+    }
+}
+
+void LinearPhaseEngine::prime(const float* const* channels, int numChannels, int numSamples)
+{
+    primeFrom(channels, numChannels, numSamples);
+}
+
+void LinearPhaseEngine::prime(const double* const* channels, int numChannels, int numSamples)
+{
+    primeFrom(channels, numChannels, numSamples);
+}
+
+void LinearPhaseEngine::processChunk(float* const* channels, int numChannels, int numSamples)
+{
+    for( int pair = 0; pair * 2 < numChannels; ++pair )
+    {
+        juce::dsp::AudioBlock<float> block(channels + pair * 2,
+                                           static_cast<size_t>(juce::jmin(2, numChannels - pair * 2)),
+                                           static_cast<size_t>(numSamples));
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        convolutions[static_cast<size_t>(pair)]->process(context);
+    }
+
+    updateReadiness(numSamples);
+}
+
+//Ядро грузится асинхронно и подменяется самой свёрткой внутри process():
+//до этого она выдаёт прежнее ядро или пропускает звук без задержки
+void LinearPhaseEngine::updateReadiness(int numSamples)
+{
+    if( convolutions.empty() )
+        return;
+
+    const auto irSize = expectedIRSize.load();
+
+    for( auto& convolution : convolutions )
+    {
+        if( irSize == 0 || convolution->getCurrentIRSize() != irSize )
+        {
+            primedSamples = 0;
+            return;
+        }
+    }
+
+    primedSamples = juce::jmin(kernelLength, primedSamples + numSamples);
+}
@@ -0,0 +1,81 @@
+/*
+    Линейно-фазовый режим эквалайзера.
+    Ядро FIR строится по амплитудной характеристике тех же биквадов, что и в снимке
+    (и в кривой отклика редактора), с нулевой фазой, сдвигом на половину длины и окном.
+    Свёртка - juce::dsp::Convolution: равномерно разбитая на блоки FFT-свёртка,
+    новое ядро подгружается в фоне и плавно подмешивается (crossfade).
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "FilterSnapshot.h"
+
+class LinearPhaseEngine
+{
+public:
+    //Максимум каналов: по одной свёртке на пару каналов
+    static constexpr int maxChannels = 16;
+
+    //Выделение свёрток, FFT и буферов (вызывается из prepareToPlay)
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    //Очистка хвостов свёртки; после неё движок снова не готов (isReady)
+    void reset();
+
+    /**Построение ядра по снимку и загрузка его в свёртки.
+    * Вызывается потоком расчёта фильтров, никогда из аудиопотока.
+    **/
+    void setResponse(const FilterSnapshot& snapshot);
+
+    //Задержка: центр симметричного ядра
+    int getLatencyInSamples() const { return kernelLength / 2; }
+
+    /**Прогон входа через свёртки с отбрасыванием результата. Пока включается линейная фаза,
+    * звук идёт прежним путём, а свёртки тем временем подменяют ядро и заполняют историю
+    **/
+    void prime(const float* const* channels, int numChannels, int numSamples);
+    void prime(const double* const* channels, int numChannels, int numSamples);
+
+    /**Последнее ядро из setResponse загружено во все свёртки, и после этого через них прошло
+    * не меньше его длины: в выходе нет ни прежнего (или пустого) ядра, ни плавного перехода от него
+    **/
+    bool isReady() const { return kernelLength > 0 && primedSamples >= kernelLength; }
+
+    //Обработка на месте; double-каналы проходят через float-буфер, выделенный заранее
+    void process(float* const* channels, int numChannels, int numSamples);
+    void process(double* const* channels, int numChannels, int numSamples);
+private:
+    //Одна очередь загрузки ядер на все свёртки вместо отдельного потока на каждую
+    juce::dsp::ConvolutionMessageQueue loadQueue;
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fftData, window;
+    juce::AudioBuffer<float> conversionBuffer;
+
+    double currentSampleRate { 0.0 };
+    int kernelLength { 0 }, maxBlockSize { 0 }, preparedChannels { 0 };
+    //Отсчётов, прошедших через свёртки с загруженным ядром (не больше kernelLength)
+    int primedSamples { 0 };
+
+    /**Все ядра одной частоты имеют длину kernelLength, поэтому номер загрузки кодируется в длине:
+    * ядро дополняется нулями до kernelLength + generation % numGenerationTags отсчётов.
+    * getCurrentIRSize() свёртки показывает, какую загрузку она уже подменила,
+    * а нули в хвосте не меняют ни звук, ни задержку
+    **/
+    static constexpr int numGenerationTags = 64;
+    juce::uint32 generation { 0 };
+    //Длина IR последней загрузки; 0 - ядро ещё не строилось. Пишет setResponse, читает аудиопоток
+    std::atomic<int> expectedIRSize { 0 };
+
+    //prepare и setResponse приходят из разных потоков
+    juce::CriticalSection designLock;
+
+    void processChunk(float* const* channels, int numChannels, int numSamples);
+    void updateReadiness(int numSamples);
+
+    template<typename SampleType>
+    void primeFrom(const SampleType* const* channels, int numChannels, int numSamples);
+};
@@ -0,0 +1,60 @@
+#include "Oversampler.h"
+
+template<typename SampleType>
+void Oversampler<SampleType>::prepare(int numChannels, int maximumBlockSize)
+{
+    preparedChannels = juce::jlimit(1, BiquadCascade<SampleType>::maxChannels, numChannels);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    for( size_t i = 0; i < stages.size(); ++i )
+    {
+        //Целочисленная задержка, чтобы хост мог точно её компенсировать
+        stages[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(static_cast<size_t>(preparedChannels),
+                                                                           i + 1,
+                                                                           juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+                                                                           true,
+                                                                           true);
+        stages[i]->initProcessing(static_cast<size_t>(maxBlockSize));
+    }
+
+    const auto current = factor;
+    factor = 0;
+    setFactor(current);
+}
+
+template<typename SampleType>
+void Oversampler<SampleType>::reset()
+{
+    for( auto& stage : stages )
+    {
+        if( stage != nullptr )
+            stage->reset();
+    }
+}
+
+template<typename SampleType>
+void Oversampler<SampleType>::setFactor(int newFactor)
+{
+    jassert(newFactor == 1 || newFactor == 2 || newFactor == maxFactor);
+
+    if( factor == newFactor )
+        return;
+
+    factor = newFactor;
+    active = nullptr;
+
+    if( factor > 1 && stages[0] != nullptr )
+    {
+        active = stages[factor == 2 ? 0 : 1].get();
+        active->reset();
+    }
+}
+
+template<typename SampleType>
+int Oversampler<SampleType>::getLatencyInSamples() const
+{
+    return active != nullptr ? juce::roundToInt(active->getLatencyInSamples()) : 0;
+}
+
+template class Oversampler<float>;
+template class Oversampler<double>;
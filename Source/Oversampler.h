@@ -0,0 +1,72 @@
+/*
+    Необязательная передискретизация 2x/4x вокруг каскада фильтров.
+    Полифазные полуполосные IIR-фильтры JUCE для каждого коэффициента создаются заранее,
+    в prepareToPlay, так что переключение режима в аудиопотоке не выделяет память.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include "BiquadCascade.h"
+
+template<typename SampleType>
+class Oversampler
+{
+public:
+    //Допустимые коэффициенты: 1 (выключено), 2, 4
+    static constexpr int maxFactor = 4;
+
+    //Создание ступеней 2x и 4x под раскладку и максимальный размер блока
+    void prepare(int numChannels, int maximumBlockSize);
+    //Сброс состояния фильтров передискретизации
+    void reset();
+
+    //Смена коэффициента (аудиопоток): новая ступень начинает с чистого состояния
+    void setFactor(int newFactor);
+    int getFactor() const { return factor; }
+
+    //Задержка текущего режима в отсчётах исходной частоты
+    int getLatencyInSamples() const;
+
+    /**Повышение частоты, обработка и понижение обратно.
+    * processOversampled(SampleType* const* channels, int numChannels, int numSamples)
+    * получает блок на частоте, увеличенной в getFactor() раз.
+    **/
+    template<typename ProcessFn>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numChannels, ProcessFn&& processOversampled)
+    {
+        numChannels = juce::jmin(numChannels, preparedChannels);
+
+        if( active == nullptr )
+        {
+            processOversampled(buffer.getArrayOfWritePointers(), numChannels, buffer.getNumSamples());
+            return;
+        }
+
+        //Блок больше заявленного обрабатывается частями
+        for( int start = 0; start < buffer.getNumSamples(); start += maxBlockSize )
+        {
+            const auto numSamples = juce::jmin(maxBlockSize, buffer.getNumSamples() - start);
+            juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(),
+                                                    static_cast<size_t>(numChannels),
+                                                    static_cast<size_t>(start),
+                                                    static_cast<size_t>(numSamples));
+
+            auto upsampled = active->processSamplesUp(block);
+            for( int ch = 0; ch < numChannels; ++ch )
+                upChannels[ch] = upsampled.getChannelPointer(static_cast<size_t>(ch));
+
+            processOversampled(upChannels.data(), numChannels, static_cast<int>(upsampled.getNumSamples()));
+
+            active->processSamplesDown(block);
+        }
+    }
+private:
+    //Ступени для 2x и 4x (одна и две каскадные полуполосные ступени)
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 2> stages;
+    juce::dsp::Oversampling<SampleType>* active { nullptr };
+
+    std::array<SampleType*, BiquadCascade<SampleType>::maxChannels> upChannels {};
+    int factor { 1 }, maxBlockSize { 0 }, preparedChannels { 0 };
+};
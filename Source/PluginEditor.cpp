@@ -223,27 +223,24 @@ juce::String RotarySliderWithLabels::getDisplayString() const
 //==============================================================================
 ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor& p) :
 audioProcessor(p),
-leftPathProducer(audioProcessor.leftChannelFifo),
-rightPathProducer(audioProcessor.rightChannelFifo)
+pathProducer(audioProcessor.leftChannelFifo, audioProcessor.rightChannelFifo)
 {
-    const auto& params = audioProcessor.getParameters();
-    for( auto param : params )
-    {
-        param->addListener(this);
-    }
-
-    updateChain();
+    pullFilterSnapshot();
+    
+    analyzerThread->addClient(this);
     
+    //Обновление в такт кадрам экрана; без VBlankAttachment - таймер с той же частотой
+   #if JUCE_MAJOR_VERSION >= 7
+    vBlankAttachment = std::make_unique<juce::VBlankAttachment>(this, [this] { refreshDisplay(); });
+   #else
     startTimerHz(60);
+   #endif
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
-    const auto& params = audioProcessor.getParameters();
-    for( auto param : params )
-    {
-        param->removeListener(this);
-    }
+    //Дожидаемся конца текущего прохода анализатора, прежде чем разрушать PathProducer
+    analyzerThread->removeClient(this);
 }
 
 void ResponseCurveComponent::updateResponseCurve()
@@ -253,52 +250,20 @@ void ResponseCurveComponent::updateResponseCurve()
     
     auto w = responseArea.getWidth();
     
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
+    //Одна точка сетки на столбец пикселей; пересчитываются только изменившиеся полосы
+    responseEngine.setGrid(w, 20.0, 20000.0);
+    const auto responseChanged = responseEngine.update(responseSnapshot);
     
-    auto sampleRate = audioProcessor.getSampleRate();
+    if( ! responseChanged && responseArea == responseCurveArea )
+        return;
     
-    std::vector<double> mags;
+    responseCurveArea = responseArea;
+    responseCurve.clear();
     
-    mags.resize(w);
+    if( responseEngine.getNumPoints() == 0 )
+        return;
     
-    for( int i = 0; i < w; ++i )
-    {
-        double mag = 1.f;
-        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
-        
-        if(! monoChain.isBypassed<ChainPositions::Peak>() )
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        
-        if( !monoChain.isBypassed<ChainPositions::LowCut>() )
-        {
-            if( !lowcut.isBypassed<0>() )
-                mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !lowcut.isBypassed<1>() )
-                mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !lowcut.isBypassed<2>() )
-                mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !lowcut.isBypassed<3>() )
-                mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-        
-        if( !monoChain.isBypassed<ChainPositions::HighCut>() )
-        {
-            if( !highcut.isBypassed<0>() )
-                mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !highcut.isBypassed<1>() )
-                mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !highcut.isBypassed<2>() )
-                mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if( !highcut.isBypassed<3>() )
-                mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-            
-        mags[i] = Decibels::gainToDecibels(mag);
-    }
-    
-    responseCurve.clear();
+    const auto* mags = responseEngine.getDecibels();
     
     const double outputMin = responseArea.getBottom();
     const double outputMax = responseArea.getY();
@@ -307,9 +272,9 @@ void ResponseCurveComponent::updateResponseCurve()
         return jmap(input, -24.0, 24.0, outputMin, outputMax);
     };
     
-    responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+    responseCurve.startNewSubPath(responseArea.getX(), map(mags[0]));
     
-    for( size_t i = 1; i < mags.size(); ++i )
+    for( int i = 1; i < responseEngine.getNumPoints(); ++i )
     {
         responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
     }
@@ -318,46 +283,89 @@ void ResponseCurveComponent::updateResponseCurve()
 void ResponseCurveComponent::paint (juce::Graphics& g)
 {
     using namespace juce;
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (Colours::black);
-
-    drawBackgroundGrid(g);
+    //Сетка, подписи и рамка меняются только с размером и масштабом экрана:
+    //каждый кадр лишь накладываются готовые слои под живыми путями и над ними
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    updateCachedLayers(scale);
+    
+    g.drawImage(backgroundLayer, getLocalBounds().toFloat());
     
     auto responseArea = getAnalysisArea();
     
     if( shouldShowFFTAnalysis )
     {
-        auto leftChannelFFTPath = leftPathProducer.getPath();
-        leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-        
-        g.setColour(Colour(97u, 18u, 167u)); //purple-
-        g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
+        //Следы пишутся в растр столбцами, уже в физических пикселях: остаётся наложить его
+        if( traceLayer.setSize(roundToInt(responseArea.getWidth() * scale), roundToInt(responseArea.getHeight() * scale)) )
+            traceLayerNeedsRedraw = true;
         
-        auto rightChannelFFTPath = rightPathProducer.getPath();
-        rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+        if( traceLayerNeedsRedraw )
+        {
+            traceLayer.clear();
+            traceLayer.draw(pathProducer.getTrace(Channel::Left), Colour(97u, 18u, 167u), scale); //purple-
+            traceLayer.draw(pathProducer.getTrace(Channel::Right), Colour(215u, 201u, 134u), scale);
+            traceLayerNeedsRedraw = false;
+        }
         
-        g.setColour(Colour(215u, 201u, 134u));
-        g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+        g.drawImage(traceLayer.getImage(), responseArea.toFloat());
     }
     
     g.setColour(Colours::white);
     g.strokePath(responseCurve, PathStrokeType(2.f));
     
-    Path border;
+    g.drawImage(foregroundLayer, getLocalBounds().toFloat());
+}
+
+void ResponseCurveComponent::updateCachedLayers(float scale)
+{
+    using namespace juce;
     
-    border.setUsingNonZeroWinding(false);
+    if( backgroundLayer.isValid() && scale == cachedLayerScale )
+        return;
     
-    border.addRoundedRectangle(getRenderArea(), 4);
-    border.addRectangle(getLocalBounds());
+    cachedLayerScale = scale;
     
-    g.setColour(Colours::black);
+    {
+        //Следующие следы анализатор построит под новый масштаб
+        const juce::SpinLock::ScopedLockType lock(analysisBoundsLock);
+        analysisScale = scale;
+    }
     
-    g.fillPath(border);
+    //Слои в физических пикселях, чтобы на HiDPI они не размывались
+    const auto width = jmax(1, roundToInt(getWidth() * scale));
+    const auto height = jmax(1, roundToInt(getHeight() * scale));
     
-    drawTextLabels(g);
+    backgroundLayer = Image(Image::RGB, width, height, true);
+    {
+        Graphics g(backgroundLayer);
+        g.addTransform(AffineTransform::scale(scale));
+        
+        // (Our component is opaque, so we must completely fill the background with a solid colour)
+        g.fillAll (Colours::black);
+        drawBackgroundGrid(g);
+    }
     
-    g.setColour(Colours::orange);
-    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+    //Верхний слой прозрачен внутри рамки: маска скругления, подписи и сама рамка
+    foregroundLayer = Image(Image::ARGB, width, height, true);
+    {
+        Graphics g(foregroundLayer);
+        g.addTransform(AffineTransform::scale(scale));
+        
+        Path border;
+        
+        border.setUsingNonZeroWinding(false);
+        
+        border.addRoundedRectangle(getRenderArea(), 4);
+        border.addRectangle(getLocalBounds());
+        
+        g.setColour(Colours::black);
+        
+        g.fillPath(border);
+        
+        drawTextLabels(g);
+        
+        g.setColour(Colours::orange);
+        g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+    }
 }
 
 std::vector<float> ResponseCurveComponent::getFrequencies()
@@ -507,93 +515,202 @@ void ResponseCurveComponent::resized()
     
     responseCurve.preallocateSpace(getWidth() * 3);
     updateResponseCurve();
+    
+    //Слои перерисуются под новый размер при следующей отрисовке
+    backgroundLayer = {};
+    foregroundLayer = {};
+    
+    const juce::SpinLock::ScopedLockType lock(analysisBoundsLock);
+    analysisBounds = getAnalysisArea().toFloat();
 }
 
-void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
+/**Шаг анализа не зависит от размера блока хоста: за одно обновление экрана считается
+* только самый свежий кадр, устаревшие пропускаются. С усреднением пропущенные кадры
+* (до maxAveragedFrames последних) не выбрасываются, а усредняются по Уэлчу.
+**/
+void PathProducer::produceFFTData(AnalyzerOverlap overlap, bool averaging)
 {
-    parametersChanged.set(true);
+    //Пока хост заново готовит кольца (prepareToPlay), проход пропускается, а не ждёт
+    const juce::ScopedTryLock leftLock(leftChannelFifo->getReaderLock());
+    const juce::ScopedTryLock rightLock(rightChannelFifo->getReaderLock());
+    
+    if( ! leftLock.isLocked() || ! rightLock.isLocked() )
+        return;
+    
+    if( ! leftChannelFifo->isPrepared() || ! rightChannelFifo->isPrepared() )
+        return;
+    
+    //Оба кольца читаются одинаковыми шагами, чтобы окна каналов совпадали по времени:
+    //отсчёты, уже записанные в одно кольцо, но ещё не в другое, дождутся следующего прохода
+    const auto fftSize = fftDataGenerator.getFFTSize();
+    const auto available = juce::jmin(leftChannelFifo->getNumSamplesAvailable(),
+                                      rightChannelFifo->getNumSamplesAvailable());
+    
+    if( overlap == Overlap_PerRefresh && ! averaging )
+    {
+        if( available > 0 )
+        {
+            fftDataGenerator.produceFFTDataForRendering(leftChannelFifo->readWindow(available, fftSize),
+                                                        rightChannelFifo->readWindow(available, fftSize),
+                                                        -48.f);
+        }
+        return;
+    }
+    
+    //Усреднение в режиме "на обновление" идёт по кадрам с перекрытием 50%
+    const auto hop = overlap == Overlap_75 ? fftSize / 4 : fftSize / 2;
+    const auto numHops = available / hop;
+    if( numHops == 0 )
+        return;
+    
+    if( ! averaging )
+    {
+        fftDataGenerator.produceFFTDataForRendering(leftChannelFifo->readWindow(numHops * hop, fftSize),
+                                                    rightChannelFifo->readWindow(numHops * hop, fftSize),
+                                                    -48.f);
+        return;
+    }
+    
+    const auto numFrames = juce::jmin(numHops, maxAveragedFrames);
+    leftChannelFifo->skipSamples((numHops - numFrames) * hop);
+    rightChannelFifo->skipSamples((numHops - numFrames) * hop);
+    
+    for( int frame = 0; frame < numFrames; ++frame )
+    {
+        fftDataGenerator.addFrameToAverage(leftChannelFifo->readWindow(hop, fftSize),
+                                           rightChannelFifo->readWindow(hop, fftSize));
+    }
+    
+    fftDataGenerator.produceAveragedFFTDataForRendering(-48.f);
 }
 
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
+void PathProducer::process(juce::Rectangle<float> fftBounds, float scale, double sampleRate, FFTOrder order, AnalyzerOverlap overlap, bool averaging)
 {
-    juce::AudioBuffer<float> tempIncomingBuffer;
-    while( leftChannelFifo->getNumCompleteBuffersAvailable() > 0 )
+    //Очередь кадров здесь пуста (ниже она вычерпывается до конца), поэтому кадр
+    //старого разрешения не может быть нарисован по сетке бинов нового
+    fftDataGenerator.changeOrder(order);
+    
+    produceFFTData(overlap, averaging);
+    
+    const auto fftSize = fftDataGenerator.getFFTSize();
+    
+    const auto binWidth = sampleRate / double(fftSize);
+
+    while( fftDataGenerator.getNumAvailableFFTDataBlocks() > 0 )
     {
-        if( leftChannelFifo->getAudioBuffer(tempIncomingBuffer) )
+        if( fftDataGenerator.getFFTData( fftFrame) )
         {
-            auto size = tempIncomingBuffer.getNumSamples();
-
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
-                                              monoBuffer.getReadPointer(0, size),
-                                              monoBuffer.getNumSamples() - size);
-
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                                              tempIncomingBuffer.getReadPointer(0, 0),
-                                              size);
+            //Тишина на входе: все бины на нижней границе, путь тот же, что в прошлый раз
+            const auto numBins = fftSize / 2;
+            const auto isSilent = juce::FloatVectorOperations::findMaximum(fftDataGenerator.getChannelData(fftFrame, 0), numBins) <= -48.f
+                               && juce::FloatVectorOperations::findMaximum(fftDataGenerator.getChannelData(fftFrame, 1), numBins) <= -48.f;
+            
+            if( isSilent && lastFrameSilent && fftBounds == lastTraceBounds && scale == lastTraceScale )
+                continue;
+            
+            lastFrameSilent = isSilent;
+            lastTraceBounds = fftBounds;
+            lastTraceScale = scale;
             
-            leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+            leftTraceGenerator.generateTrace(fftDataGenerator.getChannelData(fftFrame, 0), fftBounds, scale, fftSize, binWidth, -48.f);
+            rightTraceGenerator.generateTrace(fftDataGenerator.getChannelData(fftFrame, 1), fftBounds, scale, fftSize, binWidth, -48.f);
         }
     }
     
-    const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
-    const auto binWidth = sampleRate / double(fftSize);
+}
 
-    while( leftChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0 )
+bool PathProducer::pullLatestTraces()
+{
+    bool pulled = false;
+    
+    while( leftTraceGenerator.getNumTracesAvailable() > 0 )
     {
-        std::vector<float> fftData;
-        if( leftChannelFFTDataGenerator.getFFTData( fftData) )
-        {
-            pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
-        }
+        pulled |= leftTraceGenerator.getTrace( leftChannelTrace );
+    }
+    
+    while( rightTraceGenerator.getNumTracesAvailable() > 0 )
+    {
+        pulled |= rightTraceGenerator.getTrace( rightChannelTrace );
     }
     
-    while( pathProducer.getNumPathsAvailable() > 0 )
+    return pulled;
+}
+
+//Вызывается общим потоком анализатора. Все читатели колец отсчётов работают в этом потоке,
+//поэтому у каждого кольца всегда один читатель, сколько бы редакторов ни было открыто
+void ResponseCurveComponent::runAnalysis()
+{
+    //Скрытому редактору пути не нужны. Кольца при этом заполняются, и дальше аудиопоток
+    //отбрасывает новые отсчёты (push не пишет поверх непрочитанного): первый кадр после
+    //возврата на экран собран из отсчётов, записанных до заполнения, следующие - уже свежие
+    if( ! shouldShowFFTAnalysis || ! isDisplayActive )
+        return;
+    
+    juce::Rectangle<float> fftBounds;
+    float scale;
     {
-        pathProducer.getPath( leftChannelFFTPath );
+        const juce::SpinLock::ScopedLockType lock(analysisBoundsLock);
+        fftBounds = analysisBounds;
+        scale = analysisScale;
     }
+    
+    if( fftBounds.isEmpty() )
+        return;
+    
+    auto sampleRate = audioProcessor.getSampleRate();
+    
+    auto overlap = static_cast<AnalyzerOverlap>(audioProcessor.apvts.getRawParameterValue("Analyzer Overlap")->load());
+    auto averaging = audioProcessor.apvts.getRawParameterValue("Analyzer Averaging")->load() > 0.5f;
+    auto resolution = juce::roundToInt(audioProcessor.apvts.getRawParameterValue("Analyzer Resolution")->load());
+    auto order = static_cast<FFTOrder>(FFTOrder::order2048 + resolution);
+    
+    pathProducer.process(fftBounds, scale, sampleRate, order, overlap, averaging);
 }
 
 void ResponseCurveComponent::timerCallback()
 {
-    if( shouldShowFFTAnalysis )
+    refreshDisplay();
+}
+
+void ResponseCurveComponent::refreshDisplay()
+{
+    //Свёрнутый или закрытый другим окном редактор ничего не делает
+    auto* peer = getPeer();
+    const auto isVisible = isShowing() && peer != nullptr && ! peer->isMinimised();
+    isDisplayActive = isVisible;
+    
+    if( ! isVisible )
+        return;
+    
+    //В потоке сообщений остаётся только забрать готовые пути и перерисовать
+    bool hasNewContent = false;
+    
+    if( shouldShowFFTAnalysis && pathProducer.pullLatestTraces() )
     {
-        auto fftBounds = getAnalysisArea().toFloat();
-        auto sampleRate = audioProcessor.getSampleRate();
-        
-        leftPathProducer.process(fftBounds, sampleRate);
-        rightPathProducer.process(fftBounds, sampleRate);
+        traceLayerNeedsRedraw = true;
+        hasNewContent = true;
     }
 
-    if( parametersChanged.compareAndSetBool(false, true) )
+    //Характеристика пересчитывается только по новому снимку, а не на любой параметр
+    if( pullFilterSnapshot() )
     {
-        updateChain();
         updateResponseCurve();
+        hasNewContent = true;
     }
     
-    repaint();
+    //Без нового кадра анализатора и нового снимка перерисовывать нечего
+    if( hasNewContent )
+        repaint();
 }
 
-void ResponseCurveComponent::updateChain()
+//Фильтры рассчитываются один раз, потоком расчёта процессора: здесь только копия
+bool ResponseCurveComponent::pullFilterSnapshot()
 {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    
-    monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    if( audioProcessor.getFilterSnapshotVersion() == responseSnapshot.version )
+        return false;
     
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
-    
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(),
-                    lowCutCoefficients,
-                    chainSettings.lowCutSlope);
-    
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(),
-                    highCutCoefficients,
-                    chainSettings.highCutSlope);
+    audioProcessor.copyFilterSnapshot(responseSnapshot);
+    return true;
 }
 
 juce::Rectangle<int> ResponseCurveComponent::getRenderArea()
@@ -640,7 +757,19 @@ highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlope
 lowcutBypassButtonAttachment(audioProcessor.apvts, "LowCut Bypassed", lowcutBypassButton),
 peakBypassButtonAttachment(audioProcessor.apvts, "Peak Bypassed", peakBypassButton),
 highcutBypassButtonAttachment(audioProcessor.apvts, "HighCut Bypassed", highcutBypassButton),
-analyzerEnabledButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyzerEnabledButton)
+analyzerEnabledButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyzerEnabledButton),
+
+doublePrecisionButtonAttachment(audioProcessor.apvts, "Double Precision State", doublePrecisionButton),
+analyzerAveragingButtonAttachment(audioProcessor.apvts, "Analyzer Averaging", analyzerAveragingButton),
+
+oversamplingBox(*audioProcessor.apvts.getParameter("Oversampling"), "OS"),
+phaseModeBox(*audioProcessor.apvts.getParameter("Phase Mode"), "Phase"),
+analyzerOverlapBox(*audioProcessor.apvts.getParameter("Analyzer Overlap"), "Hop"),
+analyzerResolutionBox(*audioProcessor.apvts.getParameter("Analyzer Resolution"), "FFT"),
+oversamplingBoxAttachment(audioProcessor.apvts, "Oversampling", oversamplingBox),
+phaseModeBoxAttachment(audioProcessor.apvts, "Phase Mode", phaseModeBox),
+analyzerOverlapBoxAttachment(audioProcessor.apvts, "Analyzer Overlap", analyzerOverlapBox),
+analyzerResolutionBoxAttachment(audioProcessor.apvts, "Analyzer Resolution", analyzerResolutionBox)
 {
     peakFreqSlider.labels.add({0.f, "20Hz"});
     peakFreqSlider.labels.add({1.f, "20kHz"});
@@ -674,6 +803,9 @@ analyzerEnabledButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyz
 
     analyzerEnabledButton.setLookAndFeel(&lnf);
     
+    doublePrecisionButton.setTooltip("Double Precision State");
+    analyzerAveragingButton.setTooltip("Analyzer Averaging");
+    
     auto safePtr = juce::Component::SafePointer<SimpleEQAudioProcessorEditor>(this);
     peakBypassButton.onClick = [safePtr]()
     {
@@ -719,7 +851,7 @@ analyzerEnabledButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyz
         }
     };
     
-    setSize (480, 500);
+    setSize (480, 530);
 }
 
 SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor()
@@ -810,6 +942,18 @@ void SimpleEQAudioProcessorEditor::resized()
     
     bounds.removeFromTop(5);
     
+    auto settingsArea = bounds.removeFromTop(22);
+    doublePrecisionButton.setBounds(settingsArea.removeFromRight(65));
+    oversamplingBox.setBounds(settingsArea.removeFromRight(70).reduced(2, 0));
+    phaseModeBox.setBounds(settingsArea.removeFromRight(100).reduced(2, 0));
+    
+    settingsArea.removeFromLeft(5);
+    analyzerResolutionBox.setBounds(settingsArea.removeFromLeft(80).reduced(2, 0));
+    analyzerOverlapBox.setBounds(settingsArea.removeFromLeft(105).reduced(2, 0));
+    analyzerAveragingButton.setBounds(settingsArea.removeFromLeft(50));
+    
+    bounds.removeFromTop(5);
+    
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
     auto highCutArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
     
@@ -843,6 +987,14 @@ std::vector<juce::Component*> SimpleEQAudioProcessorEditor::getComps()
         &lowcutBypassButton,
         &peakBypassButton,
         &highcutBypassButton,
-        &analyzerEnabledButton
+        &analyzerEnabledButton,
+        
+        &doublePrecisionButton,
+        &oversamplingBox,
+        &phaseModeBox,
+        
+        &analyzerResolutionBox,
+        &analyzerOverlapBox,
+        &analyzerAveragingButton
     };
 }
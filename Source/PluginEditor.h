@@ -3,6 +3,10 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "AnalyzerThread.h"
+#include "AnalyzerFFT.h"
+#include "ResponseEngine.h"
+#include "AnalyzerTrace.h"
 
 enum FFTOrder
 {
@@ -11,136 +15,301 @@ enum FFTOrder
     order8192 = 13
 };
 
+/**Спектры левого и правого каналов одного момента времени.
+* Оба канала считаются одним комплексным БПФ (AnalyzerFFT::performStereoForward),
+* кадр очереди хранит оба спектра: левый с начала, правый со смещения getMaxFFTSize()
+**/
 template<typename BlockType>
 struct FFTDataGenerator
 {
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
+    //Планы БПФ и окна всех разрешений создаются сразу: переключение не выделяет память
+    FFTDataGenerator()
     {
-        const auto fftSize = getFFTSize();
+        for( int i = 0; i < numOrders; ++i )
+        {
+            const auto fftSize = 1 << (minOrder + i);
+            forwardFFTs[i] = AnalyzerFFT::create(minOrder + i);
+            windows[i] = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        }
         
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
-       
-        window->multiplyWithWindowingTable (fftData.data(), fftSize);       // [1]
+        //Все кадры - максимального размера, поэтому обмен с очередью не зависит от разрешения
+        fftData.resize(numChannels * maxFFTSize, 0);
+        powerSum.assign(numChannels * maxFFTSize / 2, 0);
+        fftDataFifo.prepare(fftData.size());
+    }
+    
+    //Окна приходят прямо из колец отсчётов: один или два непрерывных куска
+    void produceFFTDataForRendering(const SampleRing::ReadWindow& leftData,
+                                    const SampleRing::ReadWindow& rightData,
+                                    const float negativeInfinity)
+    {
+        computeSpectra(leftData, rightData);
         
-        forwardFFT->performFrequencyOnlyForwardTransform (fftData.data());  // [2]
+        //Мощность, нормировка и дБ одним проходом ядра под текущий процессор, без sqrt
+        const auto numBins = getFFTSize() / 2;
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            auto* spectrum = fftData.data() + ch * maxFFTSize;
+            SimdDispatch::getKernels<float>().complexToDecibels(spectrum, spectrum, numBins,
+                                                                1.f / float(numBins), negativeInfinity);
+        }
         
-        int numBins = (int)fftSize / 2;
+        fftDataFifo.pushBySwapping(fftData);
+    }
+    
+    //Усреднение по Уэлчу: кадр добавляет свою мощность к накопленной
+    void addFrameToAverage(const SampleRing::ReadWindow& leftData, const SampleRing::ReadWindow& rightData)
+    {
+        computeSpectra(leftData, rightData);
         
-        for( int i = 0; i < numBins; ++i )
+        const auto numBins = getFFTSize() / 2;
+        for( int ch = 0; ch < numChannels; ++ch )
         {
-            auto v = fftData[i];
-            if( !std::isinf(v) && !std::isnan(v) )
+            const auto* spectrum = fftData.data() + ch * maxFFTSize;
+            auto* power = powerSum.data() + ch * maxFFTSize / 2;
+            
+            for( int i = 0; i < numBins; ++i )
             {
-                v /= float(numBins);
+                const auto re = spectrum[2 * i], im = spectrum[2 * i + 1];
+                power[i] += re * re + im * im;
             }
-            else
-            {
-                v = 0.f;
-            }
-            fftData[i] = v;
         }
-
-        for( int i = 0; i < numBins; ++i )
+        
+        ++numAveragedFrames;
+    }
+    
+    //Среднеквадратичная амплитуда накопленных кадров в дБ
+    void produceAveragedFFTDataForRendering(const float negativeInfinity)
+    {
+        if( numAveragedFrames == 0 )
+            return;
+        
+        //Деление суммы на число кадров входит в масштаб амплитуды: 1 / sqrt(n)
+        const auto numBins = getFFTSize() / 2;
+        const auto scale = 1.f / (float(numBins) * std::sqrt(float(numAveragedFrames)));
+        
+        for( int ch = 0; ch < numChannels; ++ch )
         {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+            SimdDispatch::getKernels<float>().powerToDecibels(powerSum.data() + ch * maxFFTSize / 2,
+                                                              fftData.data() + ch * maxFFTSize,
+                                                              numBins, scale, negativeInfinity);
         }
+        std::fill(powerSum.begin(), powerSum.end(), 0.f);
         
-        fftDataFifo.push(fftData);
+        numAveragedFrames = 0;
+        fftDataFifo.pushBySwapping(fftData);
     }
     
+    /**Смена разрешения без выделения памяти: выбираются готовые план и окно.
+    * Вызывается в потоке анализа, когда в очереди нет кадров старого разрешения
+    **/
     void changeOrder(FFTOrder newOrder)
     {
-
-        order = newOrder;
-        auto fftSize = getFFTSize();
+        jassert(newOrder >= minOrder && newOrder < minOrder + numOrders);
         
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        if( newOrder == order )
+            return;
         
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
-
-        fftDataFifo.prepare(fftData.size());
+        order = newOrder;
+        
+        //Накопленная мощность посчитана для другой сетки бинов
+        std::fill(powerSum.begin(), powerSum.end(), 0.f);
+        numAveragedFrames = 0;
     }
     //==============================================================================
     int getFFTSize() const { return 1 << order; }
     int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
     //==============================================================================
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+    //Кадр отдаётся обменом: в fftData должен быть кадр размера getFrameSize()
+    bool getFFTData(BlockType& fftData) { return fftDataFifo.pullBySwapping(fftData); }
+    
+    static constexpr int getMaxFFTSize() { return maxFFTSize; }
+    static constexpr int getFrameSize() { return numChannels * maxFFTSize; }
+    //Спектр в дБ канала кадра: 0 - левый, 1 - правый
+    static const float* getChannelData(const BlockType& frame, int channel) { return frame.data() + channel * maxFFTSize; }
 private:
-    FFTOrder order;
+    static constexpr int minOrder = FFTOrder::order2048;
+    static constexpr int numOrders = FFTOrder::order8192 - FFTOrder::order2048 + 1;
+    static constexpr int maxFFTSize = 1 << FFTOrder::order8192;
+    static constexpr int numChannels = 2;
+    
+    FFTOrder order = FFTOrder::order2048;
     BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    std::array<std::unique_ptr<AnalyzerFFT>, numOrders> forwardFFTs;
+    std::array<std::unique_ptr<juce::dsp::WindowingFunction<float>>, numOrders> windows;
+    
+    //Накопленная мощность по бинам для усреднения, оба канала подряд
+    std::vector<float> powerSum;
+    int numAveragedFrames = 0;
     
     Fifo<BlockType> fftDataFifo;
+    
+    //Комплексные спектры на месте: пары (re, im) бинов 0..N/2 - 1 каждого канала
+    void computeSpectra(const SampleRing::ReadWindow& leftData, const SampleRing::ReadWindow& rightData)
+    {
+        const auto fftSize = getFFTSize();
+        jassert(fftData.size() == static_cast<size_t>(getFrameSize()));
+        
+        auto* left = fftData.data();
+        auto* right = fftData.data() + maxFFTSize;
+        
+        copyWindow(leftData, left);
+        copyWindow(rightData, right);
+        
+        windows[order - minOrder]->multiplyWithWindowingTable (left, fftSize);                      // [1]
+        windows[order - minOrder]->multiplyWithWindowingTable (right, fftSize);
+        
+        forwardFFTs[order - minOrder]->performStereoForward (left, right, left, right);             // [2]
+    }
+    
+    //Кольцо разворачивается в окно только здесь, когда кадр действительно считается:
+    //два куска копируются, рабочей памяти БПФ сверх окна не нужно
+    void copyWindow(const SampleRing::ReadWindow& audioData, float* input) const
+    {
+        jassert(audioData.size1 + audioData.size2 == getFFTSize());
+        juce::FloatVectorOperations::copy(input, audioData.data1, audioData.size1);
+        juce::FloatVectorOperations::copy(input + audioData.size1, audioData.data2, audioData.size2);
+    }
 };
 
-template<typename PathType>
-struct AnalyzerPathGenerator
+template<typename TraceType>
+struct AnalyzerTraceGenerator
 {
    
-    void generatePath(const std::vector<float>& renderData,
-                      juce::Rectangle<float> fftBounds,
-                      int fftSize,
-                      float binWidth,
-                      float negativeInfinity)
+    /**Бины, попавшие в один столбец пикселей, сводятся к отрезку от минимума до максимума,
+    * соседние столбцы соединяются прямыми: узкие пики на высоких частотах не теряются,
+    * как при прореживании бинов, а след сразу готов к записи в растр (AnalyzerTraceLayer).
+    * Столбцы - физические пиксели: scale - масштаб экрана
+    **/
+    void generateTrace(const float* renderData,
+                       juce::Rectangle<float> fftBounds,
+                       float scale,
+                       int fftSize,
+                       float binWidth,
+                       float negativeInfinity)
     {
         auto top = fftBounds.getY();
         auto bottom = fftBounds.getHeight();
-        auto width = fftBounds.getWidth();
+        auto numColumns = juce::jmax(1, juce::roundToInt(fftBounds.getWidth() * scale));
 
         int numBins = (int)fftSize / 2;
+        
+        updateBinColumns(numBins, binWidth, float(numColumns));
 
-        PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+        //След переиспользуется: reset() оставляет выделенную память
+        auto& t = trace;
+        t.reset(numColumns);
 
-        auto map = [bottom, top, negativeInfinity](float v)
+        auto map = [bottom, top, negativeInfinity, scale](float v)
         {
-            return juce::jmap(v,
-                              negativeInfinity, 0.f,
-                              float(bottom+10),   top);
+            return scale * juce::jmap(v,
+                                      negativeInfinity, 0.f,
+                                      float(bottom+10),   top);
         };
 
         auto y = map(renderData[0]);
 
         if( std::isnan(y) || std::isinf(y) )
-            y = bottom;
+            y = bottom * scale;
         
-        p.startNewSubPath(0, y);
+        t.include(0, y);
 
-        const int pathResolution = 2;
+        //Откуда линия уходит в следующий столбец
+        int lastColumn = 0;
+        float lastY = y;
 
-        for( int binNum = 1; binNum < numBins; binNum += pathResolution )
+        //Текущий столбец: крайние значения и какое из них встретилось раньше
+        int column = 0;
+        float low = 0, high = 0;
+        bool highFirst = true, hasColumn = false;
+        
+        auto emitColumn = [&]()
         {
-            y = map(renderData[binNum]);
-
+            const auto yHigh = map(high), yLow = map(low);
+            const auto entryY = highFirst ? yHigh : yLow;
+            const auto exitY = highFirst ? yLow : yHigh;
+            
+            if( column > lastColumn )
+                t.addLine(lastColumn, lastY, column, entryY);
+            
+            t.include(column, yHigh);
+            t.include(column, yLow);
+            
+            lastColumn = column;
+            lastY = exitY;
+        };
 
-            if( !std::isnan(y) && !std::isinf(y) )
+        for( int binNum = 1; binNum < numBins; ++binNum )
+        {
+            const auto v = renderData[binNum];
+            if( ! std::isfinite(v) )
+                continue;
+            
+            const auto binColumn = binColumns[binNum];
+            if( ! hasColumn || binColumn != column )
             {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
+                if( hasColumn )
+                    emitColumn();
+                
+                column = binColumn;
+                low = high = v;
+                highFirst = true;
+                hasColumn = true;
+            }
+            else if( v > high )
+            {
+                high = v;
+                highFirst = false;
+            }
+            else if( v < low )
+            {
+                low = v;
+                highFirst = true;
             }
         }
+        
+        if( hasColumn )
+            emitColumn();
 
-        pathFifo.push(p);
+        traceFifo.pushBySwapping(t);
     }
 
-    int getNumPathsAvailable() const
+    int getNumTracesAvailable() const
     {
-        return pathFifo.getNumAvailableForReading();
+        return traceFifo.getNumAvailableForReading();
     }
 
-    bool getPath(PathType& path)
+    bool getTrace(TraceType& newTrace)
     {
-        return pathFifo.pull(path);
+        return traceFifo.pullBySwapping(newTrace);
     }
 private:
-    Fifo<PathType> pathFifo;
+    Fifo<TraceType> traceFifo;
+    TraceType trace;
+    
+    //Столбец пикселя для каждого бина; пересчитывается только при смене размера БПФ,
+    //частоты дискретизации или ширины
+    std::vector<int> binColumns;
+    int columnsNumBins = 0;
+    float columnsBinWidth = 0, columnsWidth = 0;
+    
+    void updateBinColumns(int numBins, float binWidth, float width)
+    {
+        if( numBins == columnsNumBins && binWidth == columnsBinWidth && width == columnsWidth )
+            return;
+        
+        columnsNumBins = numBins;
+        columnsBinWidth = binWidth;
+        columnsWidth = width;
+        
+        binColumns.resize(static_cast<size_t>(numBins));
+        for( int binNum = 1; binNum < numBins; ++binNum )
+        {
+            auto binFreq = binNum * binWidth;
+            auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
+            binColumns[binNum] = static_cast<int>(std::floor(normalizedBinX * width));
+        }
+    }
 };
 
 struct LookAndFeel : juce::LookAndFeel_V4
@@ -193,40 +362,54 @@ private:
     juce::String suffix;
 };
 
+//Следы анализатора обоих каналов: окна берутся из колец с одинаковых позиций
 struct PathProducer
 {
-    PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>& scsf) :
-    leftChannelFifo(&scsf)
+    PathProducer(SingleChannelSampleFifo& leftFifo, SingleChannelSampleFifo& rightFifo) :
+    leftChannelFifo(&leftFifo),
+    rightChannelFifo(&rightFifo)
     {
-        leftChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
+        fftFrame.resize(fftDataGenerator.getFrameSize(), 0);
     }
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return leftChannelFFTPath; }
+    //Поток анализатора: БПФ, дБ и построение следов в физических пикселях (scale - масштаб экрана)
+    void process(juce::Rectangle<float> fftBounds, float scale, double sampleRate, FFTOrder order, AnalyzerOverlap overlap, bool averaging);
+    //Поток сообщений: забрать самые свежие готовые следы; false, если новых нет
+    bool pullLatestTraces();
+    const AnalyzerTrace& getTrace(Channel channel) const { return channel == Channel::Left ? leftChannelTrace : rightChannelTrace; }
 private:
-    SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>* leftChannelFifo;
+    SingleChannelSampleFifo* leftChannelFifo;
+    SingleChannelSampleFifo* rightChannelFifo;
+    
+    //Больше кадров за одно обновление не усредняется: остальные устарели
+    static constexpr int maxAveragedFrames = 8;
+    
+    void produceFFTData(AnalyzerOverlap overlap, bool averaging);
     
-    juce::AudioBuffer<float> monoBuffer;
+    FFTDataGenerator<std::vector<float>> fftDataGenerator;
+    //Кадр, которым обмениваемся с очередью генератора
+    std::vector<float> fftFrame;
     
-    FFTDataGenerator<std::vector<float>> leftChannelFFTDataGenerator;
+    AnalyzerTraceGenerator<AnalyzerTrace> leftTraceGenerator, rightTraceGenerator;
     
-    AnalyzerPathGenerator<juce::Path> pathProducer;
+    //Следы тишины не меняются: повторные не строятся и не перерисовываются
+    bool lastFrameSilent = false;
+    juce::Rectangle<float> lastTraceBounds;
+    float lastTraceScale = 0.f;
     
-    juce::Path leftChannelFFTPath;
+    AnalyzerTrace leftChannelTrace, rightChannelTrace;
 };
 
 struct ResponseCurveComponent: juce::Component,
-juce::AudioProcessorParameter::Listener,
-juce::Timer
+juce::Timer,
+AnalyzerThread::Client
 {
     ResponseCurveComponent(SimpleEQAudioProcessor&);
     ~ResponseCurveComponent();
     
-    void parameterValueChanged (int parameterIndex, float newValue) override;
-
-    void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override { }
-    
+    //Запасной вариант без VBlankAttachment (JUCE 6)
     void timerCallback() override;
+    //Анализ спектра в общем потоке анализатора
+    void runAnalysis() override;
     
     void paint(juce::Graphics& g) override;
     void resized() override;
@@ -234,25 +417,50 @@ juce::Timer
     void toggleAnalysisEnablement(bool enabled)
     {
         shouldShowFFTAnalysis = enabled;
+        repaint();
     }
 private:
     SimpleEQAudioProcessor& audioProcessor;
 
-    bool shouldShowFFTAnalysis = true;
-
-    juce::Atomic<bool> parametersChanged { false };
+    std::atomic<bool> shouldShowFFTAnalysis { true };
+    //false, пока редактор скрыт или свёрнут: поток анализатора его пропускает
+    std::atomic<bool> isDisplayActive { true };
     
-    MonoChain monoChain;
+    //Раз в кадр экрана: забрать новое и перерисовать, только если оно есть
+    void refreshDisplay();
+    
+    //Область анализатора и масштаб экрана для потока анализа, обновляются в resized() и paint()
+    juce::SpinLock analysisBoundsLock;
+    juce::Rectangle<float> analysisBounds;
+    float analysisScale { 1.f };
+
+    //Копия снимка коэффициентов процессора (тот же, что в аудиопотоке)
+    //и расчёт характеристики по полосам
+    FilterSnapshot responseSnapshot;
+    ResponseEngine responseEngine;
+    //Область, под которую построен responseCurve
+    juce::Rectangle<int> responseCurveArea;
 
     void updateResponseCurve();
     
     juce::Path responseCurve;
 
-    void updateChain();
+    //Забрать снимок процессора, если его версия сменилась
+    bool pullFilterSnapshot();
     
     void drawBackgroundGrid(juce::Graphics& g);
     void drawTextLabels(juce::Graphics& g);
     
+    //Статичные слои графика: фон с сеткой и маска рамки с подписями
+    juce::Image backgroundLayer, foregroundLayer;
+    float cachedLayerScale { 0.f };
+    //Перерисовка слоёв, если они сброшены или сменился масштаб экрана
+    void updateCachedLayers(float scale);
+    
+    //Следы анализатора, записанные прямо в растр; перезаписываются только по новым следам
+    AnalyzerTraceLayer traceLayer;
+    bool traceLayerNeedsRedraw { true };
+    
     std::vector<float> getFrequencies();
     std::vector<float> getGains();
     std::vector<float> getXs(const std::vector<float>& freqs, float left, float width);
@@ -261,7 +469,14 @@ private:
     
     juce::Rectangle<int> getAnalysisArea();
     
-    PathProducer leftPathProducer, rightPathProducer;
+    PathProducer pathProducer;
+    
+    juce::SharedResourcePointer<AnalyzerThread> analyzerThread;
+    
+   #if JUCE_MAJOR_VERSION >= 7
+    //Последним: разрушается первым и больше не вызывает refreshDisplay()
+    std::unique_ptr<juce::VBlankAttachment> vBlankAttachment;
+   #endif
 };
 //==============================================================================
 struct PowerButton : juce::ToggleButton { };
@@ -291,6 +506,22 @@ struct AnalyzerButton : juce::ToggleButton
 };
 /**
 */
+//Выпадающий список параметра-выбора: пункты - варианты самого параметра с короткой подписью
+struct ParameterChoiceBox : juce::ComboBox
+{
+    ParameterChoiceBox(juce::RangedAudioParameter& rap, const juce::String& caption)
+    {
+        //ComboBoxAttachment сопоставляет индекс варианта с порядком пунктов
+        if( auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(&rap) )
+        {
+            for( int i = 0; i < choiceParam->choices.size(); ++i )
+                addItem(caption + " " + choiceParam->choices[i], i + 1);
+        }
+        
+        setTooltip(rap.getName(64));
+    }
+};
+//==============================================================================
 class SimpleEQAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
@@ -338,6 +569,22 @@ private:
                         highcutBypassButtonAttachment,
                         analyzerEnabledButtonAttachment;
     
+    //Строка настроек под графиком: анализатор слева, обработка справа.
+    //Подписи короткие, полное имя параметра - во всплывающей подсказке
+    juce::TooltipWindow tooltipWindow { this };
+    
+    juce::ToggleButton doublePrecisionButton { "64-bit" }, analyzerAveragingButton { "Avg" };
+    ButtonAttachment doublePrecisionButtonAttachment,
+                        analyzerAveragingButtonAttachment;
+    
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
+    
+    ParameterChoiceBox oversamplingBox, phaseModeBox, analyzerOverlapBox, analyzerResolutionBox;
+    ComboBoxAttachment oversamplingBoxAttachment,
+                        phaseModeBoxAttachment,
+                        analyzerOverlapBoxAttachment,
+                        analyzerResolutionBoxAttachment;
+    
     LookAndFeel lnf;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleEQAudioProcessorEditor)
@@ -15,11 +15,24 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
                        )
 #endif
 {
+    doublePrecisionState = apvts.getRawParameterValue("Double Precision State");
+    
+    filterDesignWorker.onSnapshotDesigned = [this](const FilterSnapshot& snapshot)
+    {
+        linearPhase.setResponse(snapshot);
+        
+        {
+            const juce::SpinLock::ScopedLockType lock(displaySnapshotLock);
+            displaySnapshot = snapshot;
+        }
+        displaySnapshotVersion.store(snapshot.version, std::memory_order_release);
+    };
 }
 
 //Создание деструктора класса
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //Получение названия плагина
@@ -107,10 +120,30 @@ void SimpleEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     
     spec.sampleRate = sampleRate;
     
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    //Каскады рассчитаны на блок с максимальной передискретизацией
+    const auto numCascadeChannels = juce::jmin(getTotalNumOutputChannels(), BiquadCascade<float>::maxChannels);
+    const auto maxOversampledBlock = samplesPerBlock * Oversampler<float>::maxFactor;
+    filterCascade.prepare(maxOversampledBlock, numCascadeChannels);
+    doubleCascade.prepare(maxOversampledBlock, numCascadeChannels);
+    doublePrecisionBuffer.setSize(numCascadeChannels, juce::jmax(1, maxOversampledBlock));
+    doubleCascadeActive = isUsingDoublePrecision();
+    
+    oversampler.prepare(numCascadeChannels, samplesPerBlock);
+    doubleOversampler.prepare(numCascadeChannels, samplesPerBlock);
+    
+    //Свёртки создаются заново без ядра: линейная фаза включится после загрузки нового
+    linearPhaseRequested = false;
+    linearPhaseActive = false;
+    linearPhase.prepare(sampleRate, samplesPerBlock, numCascadeChannels);
+    
+    //Первый снимок рассчитывается синхронно, дальше - фоновым потоком
+    filterDesignWorker.prepare(sampleRate);
+    if( auto* snapshot = filterSnapshots.acquire() )
+        applySnapshot(*snapshot);
     
-    updateFilters();
+    //prepareToPlay идёт не из аудиопотока: хост должен узнать задержку до начала воспроизведения
+    cancelPendingUpdate();
+    setLatencySamples(getCurrentLatency());
     
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
@@ -137,9 +170,10 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     return true;
   #else
     // Проверяем поддержку выкладки
-    // Причём поддержка только моно или стерео потоков.
-    if (
-        layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Поддерживается любая раскладка (моно, стерео, 5.1, 7.1.4 ...) до 16 каналов:
+    // все каналы обрабатываются одним каскадом фильтров.
+    const auto numOutputChannels = layouts.getMainOutputChannelSet().size();
+    if (numOutputChannels == 0 || numOutputChannels > BiquadCascade<float>::maxChannels)
         return false;
 
     // Проверяет соответствие модели и отображения(view)
@@ -164,26 +198,162 @@ void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //Обновлеям фильтры
-    updateFilters();
+    //Забираем свежий снимок коэффициентов, если фоновый поток его опубликовал
+    if( auto* snapshot = filterSnapshots.acquire() )
+        applySnapshot(*snapshot);
     
-    //Буфер
-    juce::dsp::AudioBlock<float> block(buffer);
+    //Все каналы прогоняются через каскад фильтров за один проход,
+    //группами по ширине вектора, подобранной под число каналов (стерео - SSE2/NEON, 5.1 - AVX2, 7.1.4 - AVX-512)
+    const auto numChannels = juce::jmin(totalNumOutputChannels, buffer.getNumChannels(), BiquadCascade<float>::maxChannels);
+    
+    setDoubleCascadeActive(doublePrecisionState->load() > 0.5f);
+    if( linearPhaseActive )
+    {
+        linearPhase.process(buffer.getArrayOfWritePointers(), numChannels, buffer.getNumSamples());
+    }
+    else
+    {
+        //Пока включается линейная фаза, тот же вход параллельно прогоняется через свёртки
+        if( linearPhaseRequested )
+            linearPhase.prime(buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+        
+        oversampler.process(buffer, numChannels, [this](float* const* channels, int n, int numSamples)
+        {
+            processFilters(channels, n, numSamples);
+        });
+        
+        engageLinearPhaseIfReady();
+    }
     
-    //Вытаскиваем из буфера оборачиваем в контекст и обновляем 
-    //Потоки(музыкальная информация прогоняется через фильтры)
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    leftChannelFifo.update(buffer);
+    rightChannelFifo.update(buffer);
+    
+}
+
+//Обработка в двойной точности: хост сам передаёт double-буфер
+void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    if( auto* snapshot = filterSnapshots.acquire() )
+        applySnapshot(*snapshot);
     
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    const auto numChannels = juce::jmin(totalNumOutputChannels, buffer.getNumChannels(), BiquadCascade<double>::maxChannels);
     
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    setDoubleCascadeActive(true);
+    if( linearPhaseActive )
+    {
+        linearPhase.process(buffer.getArrayOfWritePointers(), numChannels, buffer.getNumSamples());
+    }
+    else
+    {
+        if( linearPhaseRequested )
+            linearPhase.prime(buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+        
+        doubleOversampler.process(buffer, numChannels, [this](double* const* channels, int n, int numSamples)
+        {
+            doubleCascade.process(channels, n, numSamples);
+        });
+        
+        engageLinearPhaseIfReady();
+    }
     
     leftChannelFifo.update(buffer);
     rightChannelFifo.update(buffer);
+}
+
+bool SimpleEQAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void SimpleEQAudioProcessor::setDoubleCascadeActive(bool shouldBeActive)
+{
+    if( doubleCascadeActive == shouldBeActive )
+        return;
+    
+    //Состояния выключенного каскада устарели, начинаем с нуля
+    if( shouldBeActive )
+        doubleCascade.reset();
+    else
+        filterCascade.reset();
+    
+    doubleCascadeActive = shouldBeActive;
+}
+
+void SimpleEQAudioProcessor::engageLinearPhaseIfReady()
+{
+    if( ! linearPhaseRequested || ! linearPhase.isReady() )
+        return;
+    
+    //История свёрток уже содержит весь прошедший вход: следующий блок идёт через них
+    linearPhaseActive = true;
+    updateLatency();
+}
+
+//Задержка текущего режима сообщается хосту для компенсации
+int SimpleEQAudioProcessor::getCurrentLatency() const
+{
+    if( linearPhaseActive )
+        return linearPhase.getLatencyInSamples();
     
+    return isUsingDoublePrecision() ? doubleOversampler.getLatencyInSamples()
+                                    : oversampler.getLatencyInSamples();
+}
+
+void SimpleEQAudioProcessor::updateLatency()
+{
+    //Сообщение AsyncUpdater создано заранее и не отправляется повторно, пока ждёт доставки
+    pendingLatency.store(getCurrentLatency());
+    triggerAsyncUpdate();
+}
+
+void SimpleEQAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(pendingLatency.load());
+}
+
+void SimpleEQAudioProcessor::processFilters(float* const* channels, int numChannels, int numSamples)
+{
+    if( doubleCascadeActive )
+        processWithDoubleState(channels, numChannels, numSamples);
+    else
+        filterCascade.process(channels, numChannels, numSamples);
+}
+
+//Вход и выход остаются float, а коэффициенты и состояния секций - double.
+//Рабочий буфер выделен в prepareToPlay, большие блоки обрабатываются частями
+void SimpleEQAudioProcessor::processWithDoubleState(float* const* channels, int numChannels, int numSamples)
+{
+    numChannels = juce::jmin(numChannels, doublePrecisionBuffer.getNumChannels());
+    const auto chunkSize = doublePrecisionBuffer.getNumSamples();
+    auto* const* work = doublePrecisionBuffer.getArrayOfWritePointers();
+    
+    for( int start = 0; start < numSamples; start += chunkSize )
+    {
+        const auto chunk = juce::jmin(chunkSize, numSamples - start);
+        
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            const auto* src = channels[ch] + start;
+            for( int i = 0; i < chunk; ++i )
+                work[ch][i] = static_cast<double>(src[i]);
+        }
+        
+        doubleCascade.process(work, numChannels, chunk);
+        
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            auto* dst = channels[ch] + start;
+            for( int i = 0; i < chunk; ++i )
+                dst[i] = static_cast<float>(work[ch][i]);
+        }
+    }
 }
 
 //==============================================================================
@@ -216,7 +386,7 @@ void SimpleEQAudioProcessor::setStateInformation (const void* data, int sizeInBy
     if( tree.isValid() )
     {
         apvts.replaceState(tree);
-        updateFilters();
+        filterDesignWorker.requestUpdate();
     }
 }
 
@@ -237,6 +407,10 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
     settings.peakBypassed = apvts.getRawParameterValue("Peak Bypassed")->load() > 0.5f;
     settings.highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
     
+    //Off / 2x / 4x
+    settings.oversamplingFactor = 1 << static_cast<int>(apvts.getRawParameterValue("Oversampling")->load());
+    settings.linearPhase = apvts.getRawParameterValue("Phase Mode")->load() > 0.5f;
+    
     return settings;
 }
 
@@ -249,74 +423,87 @@ Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRat
                                                                   juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
 }
 
-//Обновление  фильтров пиковой частоты
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings)
-{
-    //получение коэффициентов
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-    
-    leftChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    rightChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    
-    //Обновление на левом канале
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    //Обновление на правом канале
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-}
-
 //Обновление коэффициентов
 void updateCoefficients(Coefficients &old, const Coefficients &replacements)
 {
     *old = *replacements;
 }
 
-//Обновление низкочастотных фильтров
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings)
+//Расчёт снимка коэффициентов. Неизменившиеся полосы берутся из кэша,
+//функция никогда не вызывается из аудиопотока
+void designFilterSnapshot(const ChainSettings& chainSettings,
+                          double sampleRate,
+                          BiquadDesignCache& cache,
+                          FilterSnapshot& snapshot)
 {
-    //Создание коэффициентов для низкочастотного фильтра
-    auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
-    //Левый низкочастотный поток
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    //Правый низкочастотный поток
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    
-    //Устанавливаем фильтры в соответствующие обрабатывающие цепочки
-    leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    
-    //Обновляем фильтры 
-    updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
+    //В режиме передискретизации фильтры работают на повышенной частоте,
+    //там пик и срез высоких частот не сжимаются у Найквиста
+    sampleRate *= chainSettings.oversamplingFactor;
+    snapshot.sampleRate = sampleRate;
+    snapshot.oversamplingFactor = chainSettings.oversamplingFactor;
+    snapshot.linearPhase = chainSettings.linearPhase;
+    
+    snapshot.peak = cache.getPeak(sampleRate,
+                                  chainSettings.peakFreq,
+                                  chainSettings.peakQuality,
+                                  chainSettings.peakGainInDecibels);
+    snapshot.peakBypassed = chainSettings.peakBypassed;
+    
+    const auto& lowCut = cache.getLowCut(sampleRate, chainSettings.lowCutFreq, chainSettings.lowCutSlope + 1);
+    snapshot.lowCut = lowCut.sections;
+    snapshot.numLowCutSections = lowCut.numSections;
+    snapshot.lowCutBypassed = chainSettings.lowCutBypassed;
+    
+    const auto& highCut = cache.getHighCut(sampleRate, chainSettings.highCutFreq, chainSettings.highCutSlope + 1);
+    snapshot.highCut = highCut.sections;
+    snapshot.numHighCutSections = highCut.numSections;
+    snapshot.highCutBypassed = chainSettings.highCutBypassed;
 }
 
-//Функция обновления частотных фильтров//
-void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings)
+void SimpleEQAudioProcessor::copyFilterSnapshot(FilterSnapshot& destination) const
 {
-    //Создание фильтра высоких частот
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-    
-    //фильтр высоких частот левого потока
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    //фильтр высоких частот правого потока
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    
-    leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    const juce::SpinLock::ScopedLockType lock(displaySnapshotLock);
+    destination = displaySnapshot;
 }
 
-//Функция обновления фильтров
-void SimpleEQAudioProcessor::updateFilters()
+//Применение одного снимка коэффициентов ко всем каналам
+void SimpleEQAudioProcessor::applySnapshot(const FilterSnapshot& snapshot)
 {
-    auto chainSettings = getChainSettings(apvts);
-    //Обноаляет фильтр низких частот
-    updateLowCutFilters(chainSettings);
-    //Обновляет фильтр высоких частот
-    updatePeakFilter(chainSettings);
-    //Обновляет фильтр высоких частот
-    updateHighCutFilters(chainSettings);
+    //Смена коэффициента передискретизации: состояния фильтров от старой частоты не годятся
+    if( snapshot.oversamplingFactor != oversampler.getFactor() )
+    {
+        oversampler.setFactor(snapshot.oversamplingFactor);
+        doubleOversampler.setFactor(snapshot.oversamplingFactor);
+        filterCascade.reset();
+        doubleCascade.reset();
+        updateLatency();
+    }
+    
+    //Ядро для этого снимка уже отправлено в свёртки потоком расчёта, но загружается асинхронно:
+    //включение линейной фазы ждёт готовности движка (engageLinearPhaseIfReady), выключение - сразу
+    if( snapshot.linearPhase != linearPhaseRequested )
+    {
+        linearPhaseRequested = snapshot.linearPhase;
+        linearPhase.reset();
+        
+        if( ! linearPhaseRequested && linearPhaseActive )
+        {
+            //Каскады и передискретизация простаивали всё время линейной фазы: их состояния устарели
+            linearPhaseActive = false;
+            filterCascade.reset();
+            doubleCascade.reset();
+            oversampler.reset();
+            doubleOversampler.reset();
+            updateLatency();
+        }
+    }
+    
+    //Снимок применяется к обоим каскадам, чтобы переключение режима не ждало пересчёта
+    for( int channel = 0; channel < filterCascade.getNumChannels(); ++channel )
+        filterCascade.applySnapshot(snapshot, channel);
+    
+    for( int channel = 0; channel < doubleCascade.getNumChannels(); ++channel )
+        doubleCascade.applySnapshot(snapshot, channel);
 }
 
 /**Инициализирует модель редактора и возвращает модель раскладки
@@ -374,6 +561,22 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::crea
     layout.add(std::make_unique<juce::AudioParameterBool>("Peak Bypassed", "Peak Bypassed", false));
     layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed", "HighCut Bypassed", false));
     layout.add(std::make_unique<juce::AudioParameterBool>("Analyzer Enabled", "Analyzer Enabled", true));
+    //Шаг анализатора не зависит от размера блока хоста (см. AnalyzerOverlap)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Analyzer Overlap", "Analyzer Overlap",
+                                                            juce::StringArray { "50%", "75%", "Per Refresh" }, 0));
+    //Усреднение по Уэлчу пропущенных между обновлениями кадров
+    layout.add(std::make_unique<juce::AudioParameterBool>("Analyzer Averaging", "Analyzer Averaging", false));
+    //Размер БПФ анализатора: 8192 для низких частот, 2048 при нехватке процессора
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Analyzer Resolution", "Analyzer Resolution",
+                                                            juce::StringArray { "2048", "4096", "8192" }, 0));
+    //Состояния фильтров в double при float входе/выходе: точнее для низких срезов на 96/192 кГц
+    layout.add(std::make_unique<juce::AudioParameterBool>("Double Precision State", "Double Precision State", false));
+    //Передискретизация фильтров (для мастеринга), задержка сообщается хосту
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", "Oversampling",
+                                                            juce::StringArray { "Off", "2x", "4x" }, 0));
+    //Минимально-фазовые IIR или линейно-фазовая свёртка (задержка ~85 мс)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Phase Mode", "Phase Mode",
+                                                            juce::StringArray { "Minimum", "Linear" }, 0));
     
     return layout;
 }
@@ -5,6 +5,13 @@
 #pragma once
 #include <JuceHeader.h>
 #include <array>
+#include "FilterSnapshot.h"
+#include "BiquadDesigner.h"
+#include "FilterDesignWorker.h"
+#include "BiquadCascade.h"
+#include "Oversampler.h"
+#include "LinearPhaseEngine.h"
+#include "SampleRing.h"
 
 //Импортированный код - начало
 template<typename T>
@@ -60,6 +67,32 @@ struct Fifo
         return false;
     }
     
+    //Обмен вместо копирования: слот забирает содержимое t, а t получает прежнее содержимое слота.
+    //Для std::vector и juce::Path это обмен указателями - без выделения памяти и глубоких копий
+    bool pushBySwapping(T& t)
+    {
+        auto write = fifo.write(1);
+        if( write.blockSize1 > 0 )
+        {
+            std::swap(buffers[write.startIndex1], t);
+            return true;
+        }
+        
+        return false;
+    }
+    
+    bool pullBySwapping(T& t)
+    {
+        auto read = fifo.read(1);
+        if( read.blockSize1 > 0 )
+        {
+            std::swap(t, buffers[read.startIndex1]);
+            return true;
+        }
+        
+        return false;
+    }
+    
     int getNumAvailableForReading() const
     {
         return fifo.getNumReady();
@@ -80,9 +113,12 @@ enum Channel
     Left //левый моноканал 1
 };
 
-template<typename BlockType>
+//Отвод отсчётов одного канала для анализатора спектра.
+//Аудиопоток пишет блок в кольцо целиком, поток GUI читает окна прямо из кольца
 struct SingleChannelSampleFifo
 {
+    //Самое длинное окно анализатора (FFTOrder::order8192)
+    static constexpr int maxWindowSize = 1 << 13;
 
     //Создание стека входа-выхода потока данных
     SingleChannelSampleFifo(Channel ch) : channelToUse(ch)
@@ -90,37 +126,56 @@ struct SingleChannelSampleFifo
         prepared.set(false);
     }
     
-    //Обновление информации о потоке
-    void update(const BlockType& buffer)
+    //Обновление информации о потоке (буфер может быть float или double)
+    template<typename SampleType>
+    void update(const juce::AudioBuffer<SampleType>& buffer)
     {
         jassert(prepared.get());
-        jassert(buffer.getNumChannels() > channelToUse );
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
+        jassert(buffer.getNumChannels() > 0 );
+        //В моно раскладке оба анализатора слушают единственный канал
+        auto* channelPtr = buffer.getReadPointer(juce::jmin((int) channelToUse, buffer.getNumChannels() - 1));
         
-        for( int i = 0; i < buffer.getNumSamples(); ++i )
+        if constexpr( std::is_same_v<SampleType, float> )
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            ring.push(channelPtr, buffer.getNumSamples());
+        }
+        else
+        {
+            //double переводится во float частями через заранее выделенный буфер
+            const auto chunkSize = static_cast<int>(conversionBuffer.size());
+            for( int start = 0; start < buffer.getNumSamples(); start += chunkSize )
+            {
+                const auto numSamples = juce::jmin(chunkSize, buffer.getNumSamples() - start);
+                for( int i = 0; i < numSamples; ++i )
+                    conversionBuffer[static_cast<size_t>(i)] = static_cast<float>(channelPtr[start + i]);
+                
+                ring.push(conversionBuffer.data(), numSamples);
+            }
         }
     }
 
-    //Подготовка стекового канала
+    //Подготовка стекового канала. Аудиопоток в это время стоит, а поток анализатора
+    //может быть посреди прохода: кольцо пересоздаётся только после его окончания (getReaderLock)
     void prepare(int bufferSize)
     {
+        const juce::ScopedLock sl(readerLock);
+        
         prepared.set(false);
         size.set(bufferSize);
         
-        bufferToFill.setSize(1,             //канал
-                             bufferSize,    //кол-во примеров
-                             false,         //сохранять ли существующишь контент
-                             true,          //очистить лишнее место
-                             true);         //избежать перенос данных
-        audioBufferFifo.prepare(1, bufferSize);
-        fifoIndex = 0;
+        //Запас на несколько блоков, пока GUI не забрал данные, плюс история для самого длинного окна
+        ring.prepare(juce::jmax(bufferSize * 8, maxWindowSize), maxWindowSize);
+        conversionBuffer.assign(static_cast<size_t>(juce::jmax(1, bufferSize)), 0.f);
         prepared.set(true);
     }
 
-    //Получение информации о свободных буферах
-    int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+    /**Читатель держит эту блокировку весь проход, пока пользуется окнами кольца,
+    * и проверяет isPrepared() уже под ней. Аудиопоток её не трогает
+    **/
+    const juce::CriticalSection& getReaderLock() const { return readerLock; }
+
+    //Количество ещё не прочитанных отсчётов
+    int getNumSamplesAvailable() const { return ring.getNumReady(); }
    
    //Канал подготовлен?
     bool isPrepared() const { return prepared.get(); }
@@ -128,28 +183,17 @@ struct SingleChannelSampleFifo
     //Размер канала передачи
     int getSize() const { return size.get(); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    //Сдвиг на hop отсчётов и окно из windowSize последних отсчётов (без копирования)
+    SampleRing::ReadWindow readWindow(int hop, int windowSize) { return ring.advance(hop, windowSize); }
+    //Пропуск устаревших отсчётов
+    void skipSamples(int numSamples) { ring.skip(numSamples); }
 private:
     Channel channelToUse;
-    int fifoIndex = 0;
-    Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
+    SampleRing ring;
+    std::vector<float> conversionBuffer;
+    juce::CriticalSection readerLock;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
-    
-    //Добавление следующего элемента в канал
-    void pushNextSampleIntoFifo(float sample)
-    {
-        if (fifoIndex == bufferToFill.getNumSamples())
-        {
-            auto ok = audioBufferFifo.push(bufferToFill);
-            juce::ignoreUnused(ok);
-            fifoIndex = 0;
-        }
-        
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
-    }
 };
 
 /**Класс перечисление спусков которые могут быть у звуковой дорожки,
@@ -163,6 +207,18 @@ enum Slope
 };
 
 
+/**Шаг анализатора спектра:
+* - перекрытие окон 50% или 75% размера БПФ
+* - один кадр на обновление экрана (самые свежие отсчёты)
+**/
+enum AnalyzerOverlap
+{
+    Overlap_50,
+    Overlap_75,
+    Overlap_PerRefresh
+};
+
+
 /**Структура содержащая в себе настройки цепочки фильтрации звука**/
 struct ChainSettings
 {
@@ -170,14 +226,23 @@ struct ChainSettings
     float lowCutFreq { 0 }, highCutFreq { 0 };
     Slope lowCutSlope { Slope::Slope_12 }, highCutSlope { Slope::Slope_12 };
     bool lowCutBypassed { false }, peakBypassed { false }, highCutBypassed { false };
+    int oversamplingFactor { 1 };
+    bool linearPhase { false };
 };
 //
 
 //Настройка фильрации моноканала
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
-using Filter = juce::dsp::IIR::Filter<float>;
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+template<typename SampleType>
+using FilterT = juce::dsp::IIR::Filter<SampleType>;
+template<typename SampleType>
+using CutFilterT = juce::dsp::ProcessorChain<FilterT<SampleType>, FilterT<SampleType>, FilterT<SampleType>, FilterT<SampleType>>;
+template<typename SampleType>
+using MonoChainT = juce::dsp::ProcessorChain<CutFilterT<SampleType>, FilterT<SampleType>, CutFilterT<SampleType>>;
+
+using Filter = FilterT<float>;
+using CutFilter = CutFilterT<float>;
+using MonoChain = MonoChainT<float>;
 //
 
 /**Класс перечисления для параметров состояния цепи :
@@ -254,12 +319,19 @@ inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleR
 { return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
                                                                                       sampleRate,
                                                                                       2 * (chainSettings.highCutSlope + 1));}
+
+//Расчёт полного снимка коэффициентов цепи (вызывается вне аудиопотока)
+void designFilterSnapshot(const ChainSettings& chainSettings,
+                          double sampleRate,
+                          BiquadDesignCache& cache,
+                          FilterSnapshot& snapshot);
 //==============================================================================
 
 
 
 //Класс отвечающий за определение аудио-процессора разрабатываемого Простого Эквалайзера
-class SimpleEQAudioProcessor  : public juce::AudioProcessor
+class SimpleEQAudioProcessor  : public juce::AudioProcessor,
+                                private juce::AsyncUpdater
 {
 public:
     //Конструктор
@@ -279,6 +351,10 @@ public:
 
     //Блокировка аудиопотока
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    //Тот же блок, если хост работает в двойной точности
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    //Плагин умеет обрабатывать double напрямую
+    bool supportsDoublePrecisionProcessing() const override;
 
     //Создание редактора звука(самого эквалайзера) 
     juce::AudioProcessorEditor* createEditor() override;
@@ -318,24 +394,66 @@ public:
     //Дерево состояний значений аудио процессора
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
     
-    using BlockType = juce::AudioBuffer<float>;
-    SingleChannelSampleFifo<BlockType> leftChannelFifo { Channel::Left };
-    SingleChannelSampleFifo<BlockType> rightChannelFifo { Channel::Right };
+    SingleChannelSampleFifo leftChannelFifo { Channel::Left };
+    SingleChannelSampleFifo rightChannelFifo { Channel::Right };
+
+    /**Снимок коэффициентов и обходов для интерфейса - тот же, что применяет аудиопоток.
+    * Версия меняется с каждым новым снимком, копия берётся под короткой блокировкой
+    **/
+    juce::uint32 getFilterSnapshotVersion() const { return displaySnapshotVersion.load(std::memory_order_acquire); }
+    void copyFilterSnapshot(FilterSnapshot& destination) const;
 private:
-    //Левый моноканал, правый моноканал
-    MonoChain leftChain, rightChain;
-    
-    //Обновление фильтра высокой частоты
-    void updatePeakFilter(const ChainSettings& chainSettings);
-
-    
-    
-    //Обновление низкочастотных звуковых фильтров
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    //Обновление высокочастотных звуковых фильтров
-    void updateHighCutFilters(const ChainSettings& chainSettings);
-    //Обновление звуковых фильтров
-    void updateFilters();
+    //Каскады фильтров: каждый канал раскладки обрабатывается в своей дорожке вектора.
+    //Каскад double используется, когда хост работает в двойной точности
+    //или включён параметр "Double Precision State" (вход/выход float, состояния double)
+    BiquadCascade<float> filterCascade;
+    BiquadCascade<double> doubleCascade;
+    bool doubleCascadeActive { false };
+
+    //Рабочий буфер для режима "Double Precision State", выделяется в prepareToPlay
+    juce::AudioBuffer<double> doublePrecisionBuffer;
+    std::atomic<float>* doublePrecisionState { nullptr };
+
+    //Передискретизация вокруг каскада; коэффициент приходит вместе со снимком,
+    //поэтому коэффициенты фильтров и частота обработки всегда согласованы
+    Oversampler<float> oversampler;
+    Oversampler<double> doubleOversampler;
+
+    //Линейно-фазовый режим: ядро строится потоком расчёта фильтров,
+    //поэтому движок объявлен раньше потока и переживает его
+    LinearPhaseEngine linearPhase;
+    //Режим из снимка и режим, в котором идёт звук: линейная фаза включается,
+    //только когда движок загрузил ядро и заполнил историю (LinearPhaseEngine::isReady)
+    bool linearPhaseRequested { false };
+    bool linearPhaseActive { false };
+
+    //Копия последнего снимка для интерфейса; пишет поток расчёта, аудиопоток её не трогает
+    mutable juce::SpinLock displaySnapshotLock;
+    FilterSnapshot displaySnapshot;
+    std::atomic<juce::uint32> displaySnapshotVersion { 0 };
+
+    //Снимки коэффициентов, рассчитанные фоновым потоком
+    FilterSnapshotMailbox filterSnapshots;
+    FilterDesignWorker filterDesignWorker { apvts, filterSnapshots };
+
+    //Применение снимка ко всем каналам (без выделения памяти)
+    void applySnapshot(const FilterSnapshot& snapshot);
+    //Переключение между каскадами float и double: состояние нового каскада сбрасывается
+    void setDoubleCascadeActive(bool shouldBeActive);
+    //Задержка текущего режима (передискретизация или линейная фаза)
+    int getCurrentLatency() const;
+    /**Из аудиопотока: задержка запоминается, а хосту сообщается в потоке сообщений.
+    * setLatencySamples уведомляет хост и слушателей, в processBlock ему не место
+    **/
+    void updateLatency();
+    void handleAsyncUpdate() override;
+    std::atomic<int> pendingLatency { 0 };
+    //Переход в линейную фазу, как только движок готов; до этого звук идёт через каскад
+    void engageLinearPhaseIfReady();
+    //Обработка каскадом float или, в режиме "Double Precision State", каскадом double
+    void processFilters(float* const* channels, int numChannels, int numSamples);
+    //Обработка float-каналов каскадом double частями по размеру рабочего буфера
+    void processWithDoubleState(float* const* channels, int numChannels, int numSamples);
     
     juce::dsp::Oscillator<float> osc;
     //===========================================================================
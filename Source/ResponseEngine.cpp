@@ -0,0 +1,118 @@
+#include "ResponseEngine.h"
+
+static bool areEqual(const BiquadCoefficients& a, const BiquadCoefficients& b)
+{
+    return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
+}
+
+void ResponseEngine::setGrid(int newNumPoints, double newMinFrequency, double newMaxFrequency)
+{
+    if( newNumPoints == numPoints && newMinFrequency == minFrequency && newMaxFrequency == maxFrequency )
+        return;
+
+    numPoints = juce::jmax(0, newNumPoints);
+    minFrequency = newMinFrequency;
+    maxFrequency = newMaxFrequency;
+
+    const auto size = static_cast<size_t>(numPoints);
+    frequencies.resize(size);
+    phi.resize(size);
+    phiSquared.resize(size);
+    total.assign(size, 0.0);
+
+    for( int i = 0; i < numPoints; ++i )
+        frequencies[static_cast<size_t>(i)] = juce::mapToLog10(double(i) / double(numPoints), minFrequency, maxFrequency);
+
+    for( auto& band : bands )
+    {
+        band.decibels.assign(size, 0.0);
+        band.valid = false;
+    }
+
+    gridSampleRate = 0.0;
+}
+
+void ResponseEngine::rebuildTrigTables(double sampleRate)
+{
+    gridSampleRate = sampleRate;
+
+    for( int i = 0; i < numPoints; ++i )
+    {
+        const auto halfW = juce::MathConstants<double>::pi * frequencies[static_cast<size_t>(i)] / sampleRate;
+        const auto sinHalfW = std::sin(halfW);
+        phi[static_cast<size_t>(i)] = sinHalfW * sinHalfW;
+        phiSquared[static_cast<size_t>(i)] = phi[static_cast<size_t>(i)] * phi[static_cast<size_t>(i)];
+    }
+
+    for( auto& band : bands )
+        band.valid = false;
+}
+
+bool ResponseEngine::updateBand(BandState& band, const BiquadCoefficients* sections, int numSections)
+{
+    if( band.valid && band.numSections == numSections )
+    {
+        bool same = true;
+        for( int s = 0; s < numSections && same; ++s )
+            same = areEqual(band.sections[static_cast<size_t>(s)], sections[s]);
+
+        if( same )
+            return false;
+    }
+
+    band.numSections = numSections;
+    band.valid = true;
+
+    //Выключенная полоса ничего не добавляет
+    if( numSections == 0 )
+    {
+        std::fill(band.decibels.begin(), band.decibels.end(), 0.0);
+        return true;
+    }
+
+    //|H(e^jw)|^2 секции в виде многочленов от phi = sin^2(w/2)
+    std::array<double, 6 * maxBandSections> terms;
+    for( int s = 0; s < numSections; ++s )
+    {
+        const auto& c = sections[s];
+        band.sections[static_cast<size_t>(s)] = c;
+
+        auto* t = terms.data() + 6 * s;
+        const auto bSum = c.b0 + c.b1 + c.b2, aSum = 1.0 + c.a1 + c.a2;
+        t[0] = bSum * bSum;
+        t[1] = -4.0 * (c.b0 * c.b1 + 4.0 * c.b0 * c.b2 + c.b1 * c.b2);
+        t[2] = 16.0 * c.b0 * c.b2;
+        t[3] = aSum * aSum;
+        t[4] = -4.0 * (c.a1 + 4.0 * c.a2 + c.a1 * c.a2);
+        t[5] = 16.0 * c.a2;
+    }
+
+    kernels->biquadResponse(phi.data(), phiSquared.data(), numPoints, terms.data(), numSections,
+                            band.decibels.data(), negativeInfinity);
+    return true;
+}
+
+bool ResponseEngine::update(const FilterSnapshot& snapshot)
+{
+    if( numPoints == 0 || snapshot.sampleRate <= 0.0 )
+        return false;
+
+    if( snapshot.sampleRate != gridSampleRate )
+        rebuildTrigTables(snapshot.sampleRate);
+
+    bool changed = false;
+    changed |= updateBand(bands[LowCutBand], snapshot.lowCut.data(),
+                          snapshot.lowCutBypassed ? 0 : snapshot.numLowCutSections);
+    changed |= updateBand(bands[PeakBand], &snapshot.peak,
+                          snapshot.peakBypassed ? 0 : 1);
+    changed |= updateBand(bands[HighCutBand], snapshot.highCut.data(),
+                          snapshot.highCutBypassed ? 0 : snapshot.numHighCutSections);
+
+    if( ! changed )
+        return false;
+
+    juce::FloatVectorOperations::copy(total.data(), bands[LowCutBand].decibels.data(), numPoints);
+    juce::FloatVectorOperations::add(total.data(), bands[PeakBand].decibels.data(), numPoints);
+    juce::FloatVectorOperations::add(total.data(), bands[HighCutBand].decibels.data(), numPoints);
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+    Расчёт амплитудной характеристики цепи по снимку коэффициентов.
+    Не зависит от компонентов интерфейса: годится и для графика, и для экспорта/проверок.
+
+    Сетка частот логарифмическая, phi = sin^2(w/2) и phi^2 для неё считаются один раз.
+    В форме от phi (а не от cos(w) и cos(2w)) нет вычитания близких чисел у нуля частоты:
+    срезы на 20 Гц при 192 кГц считаются точно.
+    Вклад каждой полосы (срез низких, пик, срез высоких) в дБ хранится отдельно:
+    при изменении одной полосы пересчитывается только она, затем массивы складываются.
+    Секции вычисляются пачками ядром под текущий процессор (SimdDispatch), в double.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "FilterSnapshot.h"
+#include "SimdDispatch.h"
+
+class ResponseEngine
+{
+public:
+    //Нижняя граница дБ: ниже неё характеристика не различается на графике
+    static constexpr double negativeInfinity = -240.0;
+
+    /**Сетка из numPoints точек от minFrequency до maxFrequency (логарифмически, правый край не входит),
+    * как столбцы графика. Вызывать вне аудиопотока: может выделить память
+    **/
+    void setGrid(int numPoints, double minFrequency, double maxFrequency);
+
+    /**Пересчёт полос, изменившихся с прошлого вызова.
+    * Возвращает true, если суммарная характеристика изменилась
+    **/
+    bool update(const FilterSnapshot& snapshot);
+
+    int getNumPoints() const { return numPoints; }
+    double getFrequency(int point) const { return frequencies[static_cast<size_t>(point)]; }
+    //Суммарная характеристика в дБ, getNumPoints() значений
+    const double* getDecibels() const { return total.data(); }
+private:
+    enum Band
+    {
+        LowCutBand,
+        PeakBand,
+        HighCutBand,
+        NumBands
+    };
+
+    static constexpr int maxBandSections = FilterSnapshot::maxCutSections;
+
+    //Секции полосы в том виде, в котором их видит ядро, и её вклад в дБ
+    struct BandState
+    {
+        std::array<BiquadCoefficients, maxBandSections> sections;
+        int numSections { 0 };
+        bool valid { false };
+        std::vector<double> decibels;
+    };
+
+    int numPoints { 0 };
+    double minFrequency { 0.0 }, maxFrequency { 0.0 };
+    //Частота дискретизации, для которой посчитаны phi и phi^2
+    double gridSampleRate { 0.0 };
+
+    std::vector<double> frequencies, phi, phiSquared, total;
+    std::array<BandState, NumBands> bands;
+
+    const CascadeKernels::KernelSet<double>* kernels { &SimdDispatch::getKernels<double>() };
+
+    void rebuildTrigTables(double sampleRate);
+    bool updateBand(BandState& band, const BiquadCoefficients* sections, int numSections);
+};
@@ -0,0 +1,104 @@
+/*
+    Кольцевой буфер отсчётов без блокировок: один писатель (аудиопоток), один читатель (поток GUI).
+    Писатель кладёт блок одним-двумя memcpy, читатель берёт окно прямо из кольца
+    (один или два непрерывных куска) без промежуточных буферов.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+class SampleRing
+{
+public:
+    //Окно для чтения: первый кусок и, если окно перешло через конец кольца, второй
+    struct ReadWindow
+    {
+        const float* data1 { nullptr };
+        int size1 { 0 };
+        const float* data2 { nullptr };
+        int size2 { 0 };
+    };
+
+    /**Выделение кольца (вызывается, когда ни писатель, ни читатель не работают:
+    * буфер может переехать, а позиции сбрасываются).
+    * historySize отсчётов перед позицией чтения писатель не трогает:
+    * из них читатель собирает окно, заканчивающееся на позиции чтения.
+    **/
+    void prepare(int minCapacity, int historySize)
+    {
+        history = juce::jmax(0, historySize);
+        capacity = juce::nextPowerOfTwo(juce::jmax(1, minCapacity) + history);
+        mask = static_cast<juce::uint32>(capacity - 1);
+
+        buffer.assign(static_cast<size_t>(capacity), 0.f);
+        writePosition.store(0);
+        readPosition.store(0);
+    }
+
+    //Писатель: то, что не помещается, отбрасывается (анализатору не нужен каждый отсчёт)
+    void push(const float* samples, int numSamples)
+    {
+        const auto write = writePosition.load(std::memory_order_relaxed);
+        const auto read = readPosition.load(std::memory_order_acquire);
+
+        const auto numFree = capacity - history - static_cast<int>(write - read);
+        numSamples = juce::jmin(numSamples, numFree);
+        if( numSamples <= 0 )
+            return;
+
+        const auto start = static_cast<int>(write & mask);
+        const auto size1 = juce::jmin(numSamples, capacity - start);
+
+        std::memcpy(buffer.data() + start, samples, sizeof(float) * static_cast<size_t>(size1));
+        std::memcpy(buffer.data(), samples + size1, sizeof(float) * static_cast<size_t>(numSamples - size1));
+
+        writePosition.store(write + static_cast<juce::uint32>(numSamples), std::memory_order_release);
+    }
+
+    //Читатель: сколько новых отсчётов ещё не прочитано
+    int getNumReady() const
+    {
+        return static_cast<int>(writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed));
+    }
+
+    //Читатель: пропуск устаревших отсчётов без чтения
+    void skip(int numSamples)
+    {
+        jassert(numSamples <= getNumReady());
+        readPosition.store(readPosition.load(std::memory_order_relaxed) + static_cast<juce::uint32>(numSamples),
+                           std::memory_order_release);
+    }
+
+    /**Читатель: сдвиг позиции чтения на hop <= getNumReady() и окно из windowSize <= historySize
+    * последних отсчётов до новой позиции. Окно остаётся действительным до следующего вызова.
+    **/
+    ReadWindow advance(int hop, int windowSize)
+    {
+        jassert(hop <= getNumReady());
+        jassert(windowSize <= history);
+
+        const auto read = readPosition.load(std::memory_order_relaxed) + static_cast<juce::uint32>(hop);
+        readPosition.store(read, std::memory_order_release);
+
+        const auto start = static_cast<int>((read - static_cast<juce::uint32>(windowSize)) & mask);
+
+        ReadWindow window;
+        window.data1 = buffer.data() + start;
+        window.size1 = juce::jmin(windowSize, capacity - start);
+        window.data2 = buffer.data();
+        window.size2 = windowSize - window.size1;
+        return window;
+    }
+private:
+    std::vector<float> buffer;
+    int capacity { 0 }, history { 0 };
+    juce::uint32 mask { 0 };
+
+    //Позиции растут непрерывно (с переполнением по модулю 2^32), индекс - позиция & mask.
+    //Каждая на своей кэш-линии, чтобы писатель и читатель не мешали друг другу
+    alignas(64) std::atomic<juce::uint32> writePosition { 0 };
+    alignas(64) std::atomic<juce::uint32> readPosition { 0 };
+};
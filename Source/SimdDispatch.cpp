@@ -0,0 +1,135 @@
+#include "SimdDispatch.h"
+
+static bool isSupported(SimdLevel level)
+{
+    switch( level )
+    {
+        case SimdLevel::Scalar:
+            return true;
+       #if SIMPLEEQ_X86_KERNELS
+        case SimdLevel::SSE2:
+            return juce::SystemStats::hasSSE2();
+        case SimdLevel::AVX2:
+            return juce::SystemStats::hasAVX2();
+        case SimdLevel::AVX512:
+            return juce::SystemStats::hasAVX512F();
+       #endif
+       #if SIMPLEEQ_NEON_KERNELS
+        case SimdLevel::NEON:
+            return true;
+       #endif
+        default:
+            return false;
+    }
+}
+
+template<typename SampleType>
+static const CascadeKernels::KernelSet<SampleType>& getKernelsFor(SimdLevel level)
+{
+    switch( level )
+    {
+       #if SIMPLEEQ_X86_KERNELS
+        case SimdLevel::SSE2:
+            return CascadeKernels::getSse2Kernels<SampleType>();
+        case SimdLevel::AVX2:
+            return CascadeKernels::getAvx2Kernels<SampleType>();
+        case SimdLevel::AVX512:
+            return CascadeKernels::getAvx512Kernels<SampleType>();
+       #endif
+       #if SIMPLEEQ_NEON_KERNELS
+        case SimdLevel::NEON:
+            return CascadeKernels::getNeonKernels<SampleType>();
+       #endif
+        default:
+            return CascadeKernels::getScalarKernels<SampleType>();
+    }
+}
+
+static SimdLevel selectLevel()
+{
+    auto requested = juce::SystemStats::getEnvironmentVariable("SIMPLEEQ_SIMD", {}).trim().toLowerCase();
+    if( requested.isEmpty() )
+        return SimdDispatch::getDetectedLevel();
+
+    for( auto level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::NEON, SimdLevel::AVX2, SimdLevel::AVX512 } )
+    {
+        if( SimdDispatch::getLevelName(level) == requested )
+        {
+            if( isSupported(level) )
+                return level;
+
+            DBG("SIMPLEEQ_SIMD=" << requested << " is not supported on this machine");
+            break;
+        }
+    }
+
+    return SimdDispatch::getDetectedLevel();
+}
+
+SimdLevel SimdDispatch::getDetectedLevel()
+{
+    for( auto level : { SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::NEON, SimdLevel::SSE2 } )
+    {
+        if( isSupported(level) )
+            return level;
+    }
+
+    return SimdLevel::Scalar;
+}
+
+SimdLevel SimdDispatch::getActiveLevel()
+{
+    static const auto level = selectLevel();
+    return level;
+}
+
+template<typename SampleType>
+const CascadeKernels::KernelSet<SampleType>& SimdDispatch::getKernels()
+{
+    static const auto& kernels = getKernelsFor<SampleType>(getActiveLevel());
+    return kernels;
+}
+
+template<typename SampleType>
+const CascadeKernels::KernelSet<SampleType>& SimdDispatch::getKernelsForLanes(int numLanes)
+{
+    const auto active = getActiveLevel();
+    const auto* best = &CascadeKernels::getScalarKernels<SampleType>();
+    auto bestPasses = numLanes;
+
+    //Наборы перечислены по возрастанию ширины, поэтому при равенстве остаётся более узкий
+    for( auto level : { SimdLevel::SSE2, SimdLevel::NEON, SimdLevel::AVX2, SimdLevel::AVX512 } )
+    {
+        if( level > active || ! isSupported(level) )
+            continue;
+
+        const auto& kernels = getKernelsFor<SampleType>(level);
+        const auto passes = (numLanes + kernels.laneWidth - 1) / kernels.laneWidth;
+
+        if( passes < bestPasses )
+        {
+            best = &kernels;
+            bestPasses = passes;
+        }
+    }
+
+    return *best;
+}
+
+template const CascadeKernels::KernelSet<float>& SimdDispatch::getKernels<float>();
+template const CascadeKernels::KernelSet<double>& SimdDispatch::getKernels<double>();
+template const CascadeKernels::KernelSet<float>& SimdDispatch::getKernelsForLanes<float>(int);
+template const CascadeKernels::KernelSet<double>& SimdDispatch::getKernelsForLanes<double>(int);
+
+juce::String SimdDispatch::getLevelName(SimdLevel level)
+{
+    switch( level )
+    {
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::NEON:   return "neon";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::Scalar:
+        default:                return "scalar";
+    }
+}
@@ -0,0 +1,43 @@
+/*
+    Выбор набора ядер по возможностям процессора во время выполнения.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "CascadeKernels.h"
+
+//Наборы инструкций в порядке возрастания ширины вектора
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    NEON,
+    AVX2,
+    AVX512
+};
+
+namespace SimdDispatch
+{
+    //Лучший набор инструкций, поддерживаемый процессором и сборкой
+    SimdLevel getDetectedLevel();
+
+    /**Активный набор: определённый автоматически либо заданный переменной окружения
+    * SIMPLEEQ_SIMD = scalar | sse2 | neon | avx2 | avx512 (для замеров и тестов).
+    * Недоступный процессору набор не выбирается никогда.
+    **/
+    SimdLevel getActiveLevel();
+
+    //Ядра активного набора для float или double. Первый вызов делать вне аудиопотока (prepareToPlay)
+    template<typename SampleType>
+    const CascadeKernels::KernelSet<SampleType>& getKernels();
+
+    /**Ядра каскада на numLanes дорожек: из наборов не шире активного - тот, что обходит
+    * дорожки за наименьшее число векторов, а из равных - самый узкий. Стерео float идёт
+    * через SSE2/NEON, а не через вектор AVX-512, в котором 14 дорожек из 16 холостые;
+    * 5.1 - через AVX2, 7.1.4 - через AVX-512. Вызывать вне аудиопотока
+    **/
+    template<typename SampleType>
+    const CascadeKernels::KernelSet<SampleType>& getKernelsForLanes(int numLanes);
+
+    juce::String getLevelName(SimdLevel level);
+}